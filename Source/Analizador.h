@@ -11,6 +11,8 @@
 #pragma once
 #include <JuceHeader.h>
 #include <array>
+#include <cstring>
+#include <limits>
 #include "PluginProcessor.h"
 
 // El ciclo de generacin del analizador es el siguiente:
@@ -26,9 +28,12 @@ enum Channel
 };
 
 // Lo mismo con esta clase:
-// 1. Empujamos cosas hacia la clase -> push(const T& t)
-// 2. Obtenemos de vuelta -> pull(T& t)
+// 1. Empujamos cosas hacia la clase -> acquireWrite() devuelve un slot, se llena ahi mismo y commitWrite() lo publica
+// 2. Obtenemos de vuelta -> acquireRead() presta el slot mas viejo y releaseRead() lo devuelve
 // 3. Para ello se prepara prealocando el espacio necesario -> prepare(int numChannels, int numSamples)
+// Los slots nunca se copian: se escriben y se leen en su lugar, y como se reusan no alocan una vez que tomaron su tamano.
+// El consumidor puede hacer swap con el slot prestado para quedarse con el contenido sin copiarlo.
+// push(const T&) y pull(T&) quedan para cuando la copia no importa.
 template<typename T>
 struct Fifo
 {
@@ -58,12 +63,38 @@ struct Fifo
         }
     }
 
+    // Productor: nullptr si la fifo esta llena. Cada acquireWrite() que no devuelve nullptr lleva su commitWrite().
+    T* acquireWrite()
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToWrite(1, start1, size1, start2, size2);
+        return size1 > 0 ? &buffers[(size_t)start1] : nullptr;
+    }
+
+    void commitWrite()
+    {
+        fifo.finishedWrite(1);
+    }
+
+    // Consumidor: nullptr si la fifo esta vacia. Cada acquireRead() que no devuelve nullptr lleva su releaseRead().
+    T* acquireRead()
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToRead(1, start1, size1, start2, size2);
+        return size1 > 0 ? &buffers[(size_t)start1] : nullptr;
+    }
+
+    void releaseRead()
+    {
+        fifo.finishedRead(1);
+    }
+
     bool push(const T& t)
     {
-        auto write = fifo.write(1);
-        if (write.blockSize1 > 0)
+        if (auto* slot = acquireWrite())
         {
-            buffers[write.startIndex1] = t;
+            *slot = t;
+            commitWrite();
             return true;
         }
 
@@ -72,10 +103,10 @@ struct Fifo
 
     bool pull(T& t)
     {
-        auto read = fifo.read(1);
-        if (read.blockSize1 > 0)
+        if (auto* slot = acquireRead())
         {
-            t = buffers[read.startIndex1];
+            t = *slot;
+            releaseRead();
             return true;
         }
 
@@ -93,16 +124,57 @@ private:
 };
 
 
+// Ultimo valor publicado, sin locks (triple buffer):
+// 1. El productor escribe en getWriteBuffer() y llama a publish()
+// 2. El consumidor llama a acquireLatest(); si devuelve true, getReadBuffer() es lo mas nuevo que se publico
+// Los valores intermedios que nadie leyo se pisan. Ninguno de los dos lados espera al otro.
+template<typename T>
+struct LatestValueSlot
+{
+    T& getWriteBuffer() { return buffers[(size_t)writeIndex]; }
+
+    void publish()
+    {
+        writeIndex = middle.exchange(writeIndex | newDataBit, std::memory_order_acq_rel) & indexMask;
+    }
+
+    bool acquireLatest()
+    {
+        if ((middle.load(std::memory_order_relaxed) & newDataBit) == 0)
+            return false;
+
+        readIndex = middle.exchange(readIndex, std::memory_order_acq_rel) & indexMask;
+        return true;
+    }
+
+    const T& getReadBuffer() const { return buffers[(size_t)readIndex]; }
+private:
+    static constexpr int newDataBit = 4, indexMask = 3;
+
+    std::array<T, 3> buffers;
+    std::atomic<int> middle{ 1 };
+    int writeIndex = 0;     // solo el productor
+    int readIndex = 2;      // solo el consumidor
+};
+
+
 // De esta clase lo que nos interesa es:
-// 1. Como le pasamos los buffer -> update(const BlockType& buffer)
-// 2. Como se preparan los buffer -> prepare(int bufferSize)
-// 3. Como obtenemos los buffer de vuelta -> getNumCompleteBuffersAvailable() para saber cuantos buffers tenemos y getAudioBuffer(BlockType& buf) nos da los buffer.
+// 1. Como le pasamos los buffer -> update(const BlockType& buffer): copia el canal entero al ring con uno o dos memcpy.
+// 2. Como se prepara -> prepare(int bufferSize). El ring se aloca una sola vez en el constructor, con lugar para 8 FFTs de
+//    las grandes (30 bloques de 2048), porque el consumidor (un worker del AnalyzerService) puede estar leyendolo
+//    mientras el host vuelve a llamar a prepareToPlay: prepare() no toca la memoria ni los indices, solo cambia la
+//    generacion, y el consumidor descarta lo pendiente la proxima vez que lee.
+// 3. Como obtenemos las muestras de vuelta -> getNumSamplesAvailable() y pull(dest, numSamples), que copia una ventana
+//    de cualquier largo directo al destino.
+// Es un ring de floats de un productor (hilo de audio) y un consumidor sobre un juce::AbstractFifo.
+// Si el bloque del host no entra entero se descarta y se cuenta.
 template<typename BlockType>
 struct SingleChannelSampleFifo
 {
     SingleChannelSampleFifo(Channel ch) : channelToUse(ch)
     {
         prepared.set(false);
+        samples.assign((size_t)capacity, 0.0f);
     }
 
     void update(const BlockType& buffer)
@@ -110,55 +182,98 @@ struct SingleChannelSampleFifo
         jassert(prepared.get());
         jassert(buffer.getNumChannels() > channelToUse);
         auto* channelPtr = buffer.getReadPointer(channelToUse);
+        const auto numSamples = buffer.getNumSamples();
 
-        for (int i = 0; i < buffer.getNumSamples(); ++i)
+        if (fifo.getFreeSpace() < numSamples)
         {
-            pushNextSampleIntoFifo(channelPtr[i]);
+            ++droppedBuffers;
+            return;
         }
+
+        const auto write = fifo.write(numSamples);
+
+        if (write.blockSize1 > 0)
+            juce::FloatVectorOperations::copy(samples.data() + write.startIndex1, channelPtr, write.blockSize1);
+
+        if (write.blockSize2 > 0)
+            juce::FloatVectorOperations::copy(samples.data() + write.startIndex2, channelPtr + write.blockSize1, write.blockSize2);
     }
 
+    // Sin alocar ni resetear el AbstractFifo: lo que quedo de antes lo descarta el consumidor (ver syncWithProducer)
     void prepare(int bufferSize)
     {
-        prepared.set(false);
+        jassert(bufferSize < capacity);
         size.set(bufferSize);
-
-        bufferToFill.setSize(1,             //channel
-            bufferSize,    //num samples
-            false,         //keepExistingContent
-            true,          //clear extra space
-            true);         //avoid reallocating
-        audioBufferFifo.prepare(1, bufferSize);
-        fifoIndex = 0;
+        generation.fetch_add(1, std::memory_order_release);
         prepared.set(true);
     }
     //==============================================================================
-    int getNumCompleteBuffersAvailable() const { return audioBufferFifo.getNumAvailableForReading(); }
+    // Lado consumidor
+    int getNumSamplesAvailable()
+    {
+        syncWithProducer();
+        return fifo.getNumReady();
+    }
     bool isPrepared() const { return prepared.get(); }
     int getSize() const { return size.get(); }
     //==============================================================================
-    bool getAudioBuffer(BlockType& buf) { return audioBufferFifo.pull(buf); }
+    // Copia las numSamples muestras mas viejas en dest. Si no hay tantas no copia nada y devuelve false.
+    bool pull(float* dest, int numSamples)
+    {
+        syncWithProducer();
+
+        if (fifo.getNumReady() < numSamples)
+            return false;
+
+        const auto read = fifo.read(numSamples);
+
+        if (read.blockSize1 > 0)
+            juce::FloatVectorOperations::copy(dest, samples.data() + read.startIndex1, read.blockSize1);
+
+        if (read.blockSize2 > 0)
+            juce::FloatVectorOperations::copy(dest + read.blockSize1, samples.data() + read.startIndex2, read.blockSize2);
+
+        return true;
+    }
+
+    // Descarta las numSamples muestras mas viejas. Lado consumidor.
+    void discard(int numSamples)
+    {
+        syncWithProducer();
+        fifo.finishedRead(juce::jmin(numSamples, fifo.getNumReady()));
+    }
+
+    // Descarta todo lo pendiente. Lado consumidor: por ejemplo al reabrir el editor, para no analizar audio viejo.
+    void discardAll()
+    {
+        fifo.finishedRead(fifo.getNumReady());
+    }
+
+    // Bloques que no entraron porque la FIFO estaba llena. Solo desde el hilo de audio.
+    int getNumDroppedBuffers() const { return droppedBuffers; }
 private:
+    static constexpr int FFTOrderMax = 13;     // FFTOrder::order8192, declarado mas abajo
+    static constexpr int capacity = 8 * (1 << FFTOrderMax) + 1;    // AbstractFifo deja un lugar libre, por eso el +1
+
     Channel channelToUse;
-    int fifoIndex = 0;
-    Fifo<BlockType> audioBufferFifo;
-    BlockType bufferToFill;
-    juce::Atomic<bool> prepared = false;
-    juce::Atomic<int> size = 0;
+    int droppedBuffers = 0;
+    std::vector<float> samples;
+    juce::AbstractFifo fifo{ capacity };
+
+    // prepare() incrementa generation; el consumidor, al verla cambiada, descarta todo lo que habia antes
+    std::atomic<int> generation{ 0 };
+    int consumerGeneration = 0;    // solo el consumidor
 
-    void pushNextSampleIntoFifo(float sample)
+    void syncWithProducer()
     {
-        if (fifoIndex == bufferToFill.getNumSamples())
+        if (const auto g = generation.load(std::memory_order_acquire); g != consumerGeneration)
         {
-            auto ok = audioBufferFifo.push(bufferToFill);
-
-            juce::ignoreUnused(ok);
-
-            fifoIndex = 0;
+            consumerGeneration = g;
+            fifo.finishedRead(fifo.getNumReady());
         }
-
-        bufferToFill.setSample(0, fifoIndex, sample);
-        ++fifoIndex;
     }
+    juce::Atomic<bool> prepared = false;
+    juce::Atomic<int> size = 0;
 };
 
 // ===================================================================================================================
@@ -173,103 +288,484 @@ enum FFTOrder
     order8192 = 13
 };
 
-// Funciona asi:
-// 1. Le entregamos audio -> produceFFTDataForRendering(const juce::AudioBuffer<float>& audioData, const float negativeInfinity)
-// 2. Recibimos datos -> getFFTData(BlockType& fftData)
-// 3. Ver cuanta data queda -> getNumAvailableFFTDataBlocks()
-template<typename BlockType>
-struct FFTDataGenerator
+// Resolucion elegida para el analizador: un orden fijo o automatica segun el sample rate
+enum AnalyzerResolution
 {
-    /**
-     produces the FFT data from an audio buffer.
-     */
-    void produceFFTDataForRendering(const juce::AudioBuffer<float>& audioData, const float negativeInfinity)
+    resolutionAuto = 0,
+    resolutionDual = 1,         // graves de una FFT larga sobre la senal decimada, el resto del orden automatico
+    resolution2048 = FFTOrder::order2048,
+    resolution4096 = FFTOrder::order4096,
+    resolution8192 = FFTOrder::order8192
+};
+
+// Orden automatico: el mas chico que da a lo sumo los Hz por bin de 2048 puntos a 48 kHz (~23.4 Hz),
+// asi la resolucion en frecuencia es la misma a 44.1/48, 88.2/96 y 176.4/192 kHz
+inline FFTOrder getAutomaticFFTOrder(double sampleRate)
+{
+    constexpr double targetBinWidth = 48000.0 / (1 << FFTOrder::order2048);
+
+    for (int o = FFTOrder::order2048; o < FFTOrder::order8192; ++o)
+        if (sampleRate / (double)(1 << o) <= targetBinWidth)
+            return (FFTOrder)o;
+
+    return FFTOrder::order8192;
+}
+
+// Suavizado del espectro: cada bin se promedia con los que estan a menos de 1/(2N) de octava (N = valor del enum)
+enum AnalyzerSmoothing
+{
+    smoothingNone = 0,
+    smoothingThirdOctave = 3,
+    smoothingSixthOctave = 6,
+    smoothingTwelfthOctave = 12,
+    smoothingTwentyFourthOctave = 24
+};
+
+// Solapamiento entre FFTs consecutivas: el hop es fftSize / overlap, sin importar el tamano de bloque del host
+enum AnalyzerOverlap
+{
+    overlapNone = 1,            // hop = fftSize
+    overlapHalf = 2,            // 50%
+    overlapThreeQuarters = 4    // 75%
+};
+
+// Ventana de un orden. Despues de construido no cambia nunca, asi que lo pueden leer varios hilos a la vez.
+// La FFT no esta aca: con el motor de respaldo de JUCE, FFT::perform se serializa con un SpinLock interno y los workers
+// que compartieran un orden se esperarian entre si. Cada StereoFFTDataGenerator tiene las suyas.
+struct FFTPlan
+{
+    explicit FFTPlan(FFTOrder o)
+        : order(o),
+          window((size_t)(1 << o), juce::dsp::WindowingFunction<float>::blackmanHarris),
+          windowTable(makeWindowTable(window, (size_t)(1 << o)))
     {
-        const auto fftSize = getFFTSize();
+    }
+
+    int getSize() const { return 1 << order; }
+
+    const FFTOrder order;
+    const juce::dsp::WindowingFunction<float> window;
+    const std::vector<float> windowTable;   // la misma ventana como tabla, para aplicarla mientras se copia
+
+private:
+    static std::vector<float> makeWindowTable(const juce::dsp::WindowingFunction<float>& w, size_t size)
+    {
+        std::vector<float> table(size, 1.0f);
+        w.multiplyWithWindowingTable(table.data(), size);
+        return table;
+    }
+};
+
+// log2 aproximado para el analizador: exponente del float mas un polinomio de grado 4 para la mantisa.
+// Error maximo ~1.2e-4 en log2, o sea menos de 0.001 dB en el espectro. Para 0 devuelve -127 (queda bajo el piso en dB).
+inline float fastLog2(float x)
+{
+    juce::uint32 bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+
+    const auto exponent = (float)((int)(bits >> 23) - 127);
+
+    bits = (bits & 0x007fffffu) | 0x3f800000u;
+    float t;
+    std::memcpy(&t, &bits, sizeof(t));
+    t -= 1.0f;
+
+    return exponent + (0.00011458f + (1.4368749f + (-0.67088268f + (0.31226948f - 0.078440676f * t) * t) * t) * t);
+}
 
-        fftData.assign(fftData.size(), 0);
-        auto* readIndex = audioData.getReadPointer(0);
-        std::copy(readIndex, readIndex + fftSize, fftData.begin());
+// Un plan por cada orden de FFTOrder, creados todos en el constructor
+struct FFTPlanSet
+{
+    FFTPlanSet()
+    {
+        for (int o = FFTOrder::order2048; o <= FFTOrder::order8192; ++o)
+            plans[(size_t)(o - FFTOrder::order2048)] = std::make_unique<const FFTPlan>((FFTOrder)o);
+    }
 
-        // first apply a windowing function to our data
-        window->multiplyWithWindowingTable(fftData.data(), fftSize);       // [1]
+    const FFTPlan& get(FFTOrder order) const { return *plans[(size_t)(order - FFTOrder::order2048)]; }
 
-        // then render our FFT data..
-        forwardFFT->performFrequencyOnlyForwardTransform(fftData.data());  // [2]
+private:
+    std::array<std::unique_ptr<const FFTPlan>, 3> plans;
+};
+
+// Suavizado de fraccion de octava sobre el espectro en dB, en O(bins) para cualquier ancho:
+// 1. prepare() calcula para cada bin k su ventana [k / 2^(1/2N), k * 2^(1/2N)] (se recalcula solo al cambiar orden o N).
+// 2. process() arma las sumas prefijas del espectro y cada bin pasa a ser (suma[hi + 1] - suma[lo]) / (hi - lo + 1).
+// Las sumas son en double para que la resta no pierda precision en los bins altos.
+struct FractionalOctaveSmoother
+{
+    // Despues de esto prepare() no aloca para numBins <= maxBins
+    void reserve(int maxBins)
+    {
+        lowerBin.reserve((size_t)maxBins);
+        upperBin.reserve((size_t)maxBins);
+        prefixSum.reserve((size_t)maxBins + 1);
+    }
+
+    void prepare(int numBins, AnalyzerSmoothing newSmoothing)
+    {
+        smoothing = newSmoothing;
+        lowerBin.clear();
+        upperBin.clear();
+        prefixSum.assign((size_t)numBins + 1, 0.0);
 
-        int numBins = (int)fftSize / 2;
+        if (smoothing == smoothingNone)
+            return;
 
-        //normalize the fft values.
-        for (int i = 0; i < numBins; ++i)
+        const auto halfWidth = std::pow(2.0, 0.5 / (double)smoothing);
+
+        for (int k = 0; k < numBins; ++k)
         {
-            fftData[i] /= (float)numBins;
+            lowerBin.push_back(juce::jlimit(0, k, (int)std::ceil((double)k / halfWidth)));
+            upperBin.push_back(juce::jlimit(k, numBins - 1, (int)std::floor((double)k * halfWidth)));
         }
+    }
+
+    AnalyzerSmoothing getSmoothing() const { return smoothing; }
+
+    // En el lugar: numBins tiene que ser el de prepare()
+    void process(float* decibels, int numBins)
+    {
+        if (smoothing == smoothingNone)
+            return;
+
+        jassert((size_t)numBins == lowerBin.size());
+
+        for (int k = 0; k < numBins; ++k)
+            prefixSum[(size_t)k + 1] = prefixSum[(size_t)k] + (double)decibels[k];
 
-        //convert them to decibels
-        for (int i = 0; i < numBins; ++i)
+        for (int k = 0; k < numBins; ++k)
         {
-            fftData[i] = juce::Decibels::gainToDecibels(fftData[i], negativeInfinity);
+            const auto lo = lowerBin[(size_t)k], hi = upperBin[(size_t)k];
+            decibels[k] = (float)((prefixSum[(size_t)hi + 1] - prefixSum[(size_t)lo]) / (double)(hi - lo + 1));
         }
-
-        fftDataFifo.push(fftData);
     }
 
-    void changeOrder(FFTOrder newOrder)
+private:
+    AnalyzerSmoothing smoothing = smoothingNone;
+    std::vector<int> lowerBin, upperBin;
+    std::vector<double> prefixSum;
+};
+
+// Genera los espectros del analizador con una sola FFT compleja para los dos canales.
+// 1. Se arma z[n] = L[n] + j * R[n] (con la ventana aplicada) y se transforma una vez.
+// 2. Como L y R son reales, sus espectros salen de la simetria conjugada:
+//    L[k] = (Z[k] + conj(Z[N - k])) / 2     R[k] = (Z[k] - conj(Z[N - k])) / 2j
+// Cada slot tiene el espectro izquierdo en [0, numBins) y el derecho en [numBins, 2 * numBins), en dB.
+template<typename BlockType>
+struct StereoFFTDataGenerator
+{
+    // audioData es un historial circular de 2 canales y fftSize muestras; la muestra mas vieja esta en oldestSample.
+    // La ventana se aplica mientras se recorre el historial en orden (window-on-gather), asi nunca hay que correrlo.
+    void produceFFTDataForRendering(const juce::AudioBuffer<float>& audioData, int oldestSample, const float negativeInfinity)
     {
-        //when you change order, recreate the window, forwardFFT, fifo, fftData
-        //also reset the fifoIndex
-        //things that need recreating should be created on the heap via std::make_unique<>
+        jassert(audioData.getNumChannels() >= 2 && audioData.getNumSamples() == getFFTSize());
+        jassert(oldestSample >= 0 && oldestSample < getFFTSize());
+        const auto fftSize = getFFTSize();
 
-        order = newOrder;
-        auto fftSize = getFFTSize();
+        auto* slot = fftDataFifo.acquireWrite();
+        if (slot == nullptr)
+            return;
 
-        forwardFFT = std::make_unique<juce::dsp::FFT>(order);
-        window = std::make_unique<juce::dsp::WindowingFunction<float>>(fftSize, juce::dsp::WindowingFunction<float>::blackmanHarris);
+        auto* left = audioData.getReadPointer(0);
+        auto* right = audioData.getReadPointer(1);
+        auto* window = plan->windowTable.data();
+        auto* input = fftInput.data();
 
-        fftData.clear();
-        fftData.resize(fftSize * 2, 0);
+        // Dos tramos contiguos: [oldestSample, fftSize) y despues [0, oldestSample)
+        const int firstPart = fftSize - oldestSample;
+        gatherWindowed(left + oldestSample, right + oldestSample, window, input, firstPart);
+        gatherWindowed(left, right, window + firstPart, input + firstPart, oldestSample);
 
-        fftDataFifo.prepare(fftData.size());
+        fft->perform(fftInput.data(), fftOutput.data(), false);
+
+        const int numBins = fftSize / 2;
+        splitToDecibels(reinterpret_cast<const float*>(fftOutput.data()), slot->data(), slot->data() + numBins, fftSize, negativeInfinity);
+        smoother.process(slot->data(), numBins);
+        smoother.process(slot->data() + numBins, numBins);
+
+        fftDataFifo.commitWrite();
+    }
+
+    // Desde el hilo que usa el generador: reserva los buffers para el orden mas grande y crea una FFT por orden.
+    // Despues de esto changeOrder() nunca aloca (los vectores solo se achican o vuelven a crecer dentro de su capacidad).
+    void preallocate(FFTOrder maxOrder)
+    {
+        for (int o = FFTOrder::order2048; o <= maxOrder; ++o)
+            if (auto& engine = ffts[(size_t)(o - FFTOrder::order2048)]; engine == nullptr)
+                engine = std::make_unique<juce::dsp::FFT>(o);
+
+        const auto maxSize = (size_t)(1 << maxOrder);
+        fftDataFifo.prepare(maxSize);
+        fftInput.reserve(maxSize);
+        fftOutput.reserve(maxSize);
+        smoother.reserve((int)maxSize / 2);
+    }
+
+    void changeOrder(const FFTPlan& newPlan)
+    {
+        plan = &newPlan;
+        fft = ffts[(size_t)(newPlan.order - FFTOrder::order2048)].get();
+        jassert(fft != nullptr);    // falta preallocate() con un orden al menos tan grande
+        fftDataFifo.prepare((size_t)plan->getSize());
+        fftInput.assign((size_t)plan->getSize(), {});
+        fftOutput.assign((size_t)plan->getSize(), {});
+        smoother.prepare(plan->getSize() / 2, smoother.getSmoothing());
     }
+
+    void setSmoothing(AnalyzerSmoothing smoothing) { smoother.prepare(getFFTSize() / 2, smoothing); }
+    AnalyzerSmoothing getSmoothing() const { return smoother.getSmoothing(); }
     //==============================================================================
-    int getFFTSize() const { return 1 << order; }
+    int getFFTSize() const { return plan->getSize(); }
+    FFTOrder getOrder() const { return plan->order; }
     int getNumAvailableFFTDataBlocks() const { return fftDataFifo.getNumAvailableForReading(); }
     //==============================================================================
-    bool getFFTData(BlockType& fftData) { return fftDataFifo.pull(fftData); }
+    const BlockType* acquireFFTData() { return fftDataFifo.acquireRead(); }
+    void releaseFFTData() { fftDataFifo.releaseRead(); }
 private:
-    FFTOrder order;
-    BlockType fftData;
-    std::unique_ptr<juce::dsp::FFT> forwardFFT;
-    std::unique_ptr<juce::dsp::WindowingFunction<float>> window;
+    const FFTPlan* plan = nullptr;
+    std::array<std::unique_ptr<juce::dsp::FFT>, 3> ffts;
+    juce::dsp::FFT* fft = nullptr;
+    std::vector<juce::dsp::Complex<float>> fftInput, fftOutput;
+    FractionalOctaveSmoother smoother;
 
     Fifo<BlockType> fftDataFifo;
+
+    static void gatherWindowed(const float* left, const float* right, const float* window, juce::dsp::Complex<float>* dest, int numSamples)
+    {
+        for (int i = 0; i < numSamples; ++i)
+            dest[i] = { left[i] * window[i], right[i] * window[i] };
+    }
+
+    // dB = 10 * log10(re^2 + im^2) - 20 * log10(numBins) - 20 * log10(2): la normalizacion y el /2 de la separacion
+    // quedan como una constante sumada. El loop no tiene saltos ni llamadas, asi el compilador lo vectoriza.
+    static void splitToDecibels(const float* z, float* leftDecibels, float* rightDecibels, int fftSize, float negativeInfinity)
+    {
+        constexpr float decibelsPerLog2 = 3.01029995664f;   // 10 * log10(2)
+        const int numBins = fftSize / 2;
+        const float normalisation = -20.0f * std::log10((float)numBins) - 20.0f * std::log10(2.0f);
+
+        for (int k = 0; k < numBins; ++k)
+        {
+            const int mirror = (fftSize - k) & (fftSize - 1);
+
+            const auto aRe = z[2 * k], aIm = z[2 * k + 1];
+            const auto bRe = z[2 * mirror], bIm = z[2 * mirror + 1];
+
+            const auto leftRe = aRe + bRe, leftIm = aIm - bIm;
+            const auto rightRe = aRe - bRe, rightIm = aIm + bIm;
+
+            leftDecibels[k] = juce::jmax(negativeInfinity, decibelsPerLog2 * fastLog2(leftRe * leftRe + leftIm * leftIm) + normalisation);
+            rightDecibels[k] = juce::jmax(negativeInfinity, decibelsPerLog2 * fastLog2(rightRe * rightRe + rightIm * rightIm) + normalisation);
+        }
+    }
+};
+
+// Decimador estereo para la banda de graves del modo de doble resolucion:
+// 1. Pasa-bajos Butterworth de 4o orden (dos biquads) apenas por encima de la banda que se va a mostrar.
+// 2. Se queda con una de cada factor muestras y la escribe en un historial circular de 2 canales.
+// Una FFT de 2048 puntos sobre la senal decimada tiene la resolucion en Hz de una de 16384 a la frecuencia original.
+// Lo que cae en la banda mostrada (hasta passbandHz) viene de sampleRate / factor - passbandHz para arriba: con el corte
+// en 1.4 * passbandHz eso queda ~70 dB abajo (5.5 kHz a 48 kHz), bajo el piso del analizador. En passbandHz cae 0.3 dB.
+struct StereoDecimator
+{
+    static constexpr int factor = 8;
+
+    // Aloca los coeficientes: fuera del hilo de audio, solo cuando cambia el sample rate
+    void prepare(double sampleRate, float passbandHz)
+    {
+        // Con sample rates muy bajos el corte no puede pasar del 80% de la nueva frecuencia de Nyquist
+        const auto cutoff = juce::jmin(1.4 * passbandHz, 0.8 * sampleRate / (2.0 * factor));
+        auto first = juce::dsp::IIR::Coefficients<float>::makeLowPass(sampleRate, (float)cutoff, 0.54119610f);
+        auto second = juce::dsp::IIR::Coefficients<float>::makeLowPass(sampleRate, (float)cutoff, 1.3065630f);
+
+        for (auto& channel : stages)
+        {
+            channel[0].coefficients = first;
+            channel[1].coefficients = second;
+        }
+
+        preparedSampleRate = sampleRate;
+        reset();
+    }
+
+    void reset()
+    {
+        for (auto& channel : stages)
+            for (auto& stage : channel)
+                stage.reset();
+
+        phase = 0;
+    }
+
+    double getSampleRate() const { return preparedSampleRate; }
+
+    // Filtra numSamples de cada canal y escribe las muestras que quedan en history desde writePosition (dando la vuelta).
+    // Devuelve cuantas muestras escribio.
+    int process(const float* left, const float* right, int numSamples, juce::AudioBuffer<float>& history, int& writePosition)
+    {
+        const auto historySize = history.getNumSamples();
+        auto* outLeft = history.getWritePointer(0);
+        auto* outRight = history.getWritePointer(1);
+        int numWritten = 0;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const auto l = stages[0][1].processSample(stages[0][0].processSample(left[i]));
+            const auto r = stages[1][1].processSample(stages[1][0].processSample(right[i]));
+
+            if (++phase == factor)
+            {
+                phase = 0;
+                outLeft[writePosition] = l;
+                outRight[writePosition] = r;
+                writePosition = (writePosition + 1) % historySize;
+                ++numWritten;
+            }
+        }
+
+        return numWritten;
+    }
+
+private:
+    std::array<std::array<juce::dsp::IIR::Filter<float>, 2>, 2> stages;
+    int phase = 0;
+    double preparedSampleRate = 0.0;
+};
+
+// Balistica del espectro, entre la FFT y el path: estado por bin que persiste entre frames.
+// 1. Promedio exponencial: average += a * (x - average), con a = 1 - exp(-dt / averagingSeconds).
+// 2. Lo que se muestra sube al instante hasta el promedio. Al bajar, primero se retiene holdSeconds
+//    (infinito = retencion de picos permanente) y despues cae a decayDecibelsPerSecond (infinito = sin caida lenta).
+// Los lazos no tienen ramas, asi el compilador los vectoriza sobre todo el arreglo de bins.
+struct SpectrumBallistics
+{
+    struct Settings
+    {
+        float averagingSeconds = 0.0f;
+        float holdSeconds = 0.0f;
+        float decayDecibelsPerSecond = std::numeric_limits<float>::infinity();
+    };
+
+    // Despues de esto prepare() no aloca para numValues <= maxValues
+    void reserve(int maxValues)
+    {
+        average.reserve((size_t)maxValues);
+        display.reserve((size_t)maxValues);
+        holdTime.reserve((size_t)maxValues);
+    }
+
+    void prepare(int numValues)
+    {
+        average.assign((size_t)numValues, 0.0f);
+        display.assign((size_t)numValues, 0.0f);
+        holdTime.assign((size_t)numValues, 0.0f);
+        reset();
+    }
+
+    // El proximo frame se toma tal cual, sin historia
+    void reset() { hasState = false; }
+
+    // input tiene tantos valores como se pasaron a prepare(); frameSeconds es el audio que avanzo desde el frame anterior
+    void process(const float* input, float frameSeconds, const Settings& settings)
+    {
+        const auto numValues = (int)display.size();
+        auto* avg = average.data();
+        auto* disp = display.data();
+        auto* held = holdTime.data();
+
+        if (!hasState)
+        {
+            std::copy(input, input + numValues, avg);
+            std::copy(input, input + numValues, disp);
+            std::fill(held, held + numValues, 0.0f);
+            hasState = true;
+            return;
+        }
+
+        const auto a = settings.averagingSeconds > 0.0f ? 1.0f - std::exp(-frameSeconds / settings.averagingSeconds) : 1.0f;
+        // inf * 0 seria NaN: sin caida lenta el paso es infinito aunque el frame dure 0
+        const auto decayStep = std::isinf(settings.decayDecibelsPerSecond) ? settings.decayDecibelsPerSecond
+                                                                            : settings.decayDecibelsPerSecond * frameSeconds;
+        const auto holdSeconds = settings.holdSeconds;
+
+        for (int k = 0; k < numValues; ++k)
+        {
+            const auto newAverage = avg[k] + a * (input[k] - avg[k]);
+            avg[k] = newAverage;
+
+            const auto rising = newAverage >= disp[k];
+            const auto newHoldTime = held[k] + frameSeconds;
+            const auto fallen = juce::jmax(newAverage, disp[k] - (newHoldTime > holdSeconds ? decayStep : 0.0f));
+
+            held[k] = rising ? 0.0f : newHoldTime;
+            disp[k] = rising ? newAverage : fallen;
+        }
+    }
+
+    const float* getOutput() const { return display.data(); }
+
+private:
+    std::vector<float> average, display, holdTime;
+    bool hasState = false;
 };
 
 // ===================================================================================================================
  
 // Path Generator
-// 1. Le damos FFT Data -> generatePath(...)
+// 1. Le damos FFT Data -> generatePath(...), que deja un vertice por columna de pixels (el maximo de sus bins)
 // 2. Devuelve un Path -> getPath(PathType& path)
 template<typename PathType>
 struct AnalyzerPathGenerator
 {
+    // Una banda del espectro: los bins de data (fftSize / 2 valores en dB) desde minFrequency hasta antes de maxFrequency
+    struct SpectrumBand
+    {
+        const float* data;
+        int fftSize;
+        float binWidth;
+        float minFrequency, maxFrequency;
+    };
+
+    static constexpr int maxBands = 2;
+
     /*
      converts 'renderData[]' into a juce::Path
      */
-    void generatePath(const std::vector<float>& renderData,
+    void generatePath(const float* renderData,
         juce::Rectangle<float> fftBounds,
         int fftSize,
         float binWidth,
         float negativeInfinity)
     {
+        const SpectrumBand band{ renderData, fftSize, binWidth, 0.0f, std::numeric_limits<float>::max() };
+        generatePath(&band, 1, fftBounds, negativeInfinity);
+    }
+
+    // Varias bandas ordenadas por frecuencia unidas en un solo path (por ejemplo graves de una FFT larga y el resto de una corta)
+    void generatePath(const SpectrumBand* bands, int numBands,
+        juce::Rectangle<float> fftBounds,
+        float negativeInfinity)
+    {
+        jassert(numBands > 0 && numBands <= maxBands);
+
         auto top = fftBounds.getY();
         auto bottom = fftBounds.getHeight();
-        auto width = fftBounds.getWidth();
 
-        int numBins = (int)fftSize / 2;
+        // La tabla bin -> columna solo se recalcula si cambian el ancho, el orden de la FFT o las bandas
+        updateColumnTable((int)fftBounds.getWidth(), bands, numBands);
+
+        if (columns.empty())
+            return;
 
-        PathType p;
-        p.preallocateSpace(3 * (int)fftBounds.getWidth());
+        // El path se arma en el slot de la fifo: clear() conserva la memoria del uso anterior
+        auto* slot = pathFifo.acquireWrite();
+        if (slot == nullptr)
+            return;
+
+        PathType& p = *slot;
+        p.clear();
+        p.preallocateSpace(3 * ((int)columns.size() + 1));
 
         auto map = [bottom, top, negativeInfinity](float v)
             {
@@ -278,30 +774,24 @@ struct AnalyzerPathGenerator
                     float(bottom), top);
             };
 
-        auto y = map(renderData[0]);
-
-        jassert(!std::isnan(y) && !std::isinf(y));
-
-        p.startNewSubPath(0, y);
-
-        const int pathResolution = 2; //you can draw line-to's every 'pathResolution' pixels.
-
-        for (int binNum = 1; binNum < numBins; binNum += pathResolution)
+        // Un vertice por columna de pixels, con el maximo de los bins que caen en ella: asi no se pierden picos
+        // en los agudos, donde muchos bins comparten columna. En los graves (un bin cada varias columnas)
+        // las columnas sin bins se saltean y la linea une los vertices vecinos.
+        for (size_t i = 0; i < columns.size(); ++i)
         {
-            y = map(renderData[binNum]);
+            const auto& column = columns[i];
+            const auto peak = juce::FloatVectorOperations::findMaximum(bands[column.band].data + column.firstBin, column.numBins);
+            const auto y = map(peak);
 
             jassert(!std::isnan(y) && !std::isinf(y));
 
-            if (!std::isnan(y) && !std::isinf(y))
-            {
-                auto binFreq = binNum * binWidth;
-                auto normalizedBinX = juce::mapFromLog10(binFreq, 20.f, 20000.f);
-                int binX = std::floor(normalizedBinX * width);
-                p.lineTo(binX, y);
-            }
+            if (i == 0)
+                p.startNewSubPath((float)column.x, y);
+            else
+                p.lineTo((float)column.x, y);
         }
 
-        pathFifo.push(p);
+        pathFifo.commitWrite();
     }
 
     int getNumPathsAvailable() const
@@ -309,10 +799,84 @@ struct AnalyzerPathGenerator
         return pathFifo.getNumAvailableForReading();
     }
 
-    bool getPath(PathType& path)
+    // Intercambia path con el Path mas nuevo de la fifo (sin copiar) y descarta los anteriores
+    bool swapWithNewestPath(PathType& path)
     {
-        return pathFifo.pull(path);
+        while (pathFifo.getNumAvailableForReading() > 1)
+        {
+            pathFifo.acquireRead();
+            pathFifo.releaseRead();
+        }
+
+        if (auto* slot = pathFifo.acquireRead())
+        {
+            path.swapWithPath(*slot);
+            pathFifo.releaseRead();
+            return true;
+        }
+
+        return false;
     }
 private:
+    struct Column
+    {
+        int x;          // columna de pixels
+        int band;       // banda de donde salen los bins
+        int firstBin;   // primer bin que cae en la columna
+        int numBins;    // bins contiguos desde firstBin
+    };
+
     Fifo<PathType> pathFifo;
+
+    std::vector<Column> columns;
+    int tableWidth = -1, tableNumBands = 0;
+    std::array<SpectrumBand, maxBands> tableBands{};
+
+    static bool sameLayout(const SpectrumBand& a, const SpectrumBand& b)
+    {
+        return a.fftSize == b.fftSize && a.binWidth == b.binWidth && a.minFrequency == b.minFrequency && a.maxFrequency == b.maxFrequency;
+    }
+
+    void updateColumnTable(int width, const SpectrumBand* bands, int numBands)
+    {
+        if (width == tableWidth && numBands == tableNumBands
+            && std::equal(bands, bands + numBands, tableBands.begin(), sameLayout))
+            return;
+
+        tableWidth = width;
+        tableNumBands = numBands;
+        std::copy(bands, bands + numBands, tableBands.begin());
+        columns.clear();
+
+        if (width <= 0)
+            return;
+
+        // Sin el bin 0 (continua): los bins por debajo de 20 Hz van a la columna 0 y los de mas de 20 kHz no se dibujan
+        for (int band = 0; band < numBands; ++band)
+        {
+            const auto& b = bands[band];
+            if (b.binWidth <= 0.0f)
+                continue;
+
+            for (int binNum = 1; binNum < b.fftSize / 2; ++binNum)
+            {
+                const auto binFreq = binNum * b.binWidth;
+                if (binFreq < b.minFrequency)
+                    continue;
+                if (binFreq >= b.maxFrequency)
+                    break;
+
+                const auto normalizedBinX = juce::mapFromLog10(binFreq, 20.f, 20000.f);
+                const auto binX = juce::jmax(0, (int)std::floor(normalizedBinX * (float)width));
+
+                if (binX > width)
+                    break;
+
+                if (!columns.empty() && columns.back().x == binX && columns.back().band == band)
+                    ++columns.back().numBins;
+                else
+                    columns.push_back({ binX, band, binNum, 1 });
+            }
+        }
+    }
 };
\ No newline at end of file
@@ -0,0 +1,117 @@
+/*
+  ==============================================================================
+
+    CargaDSP.h
+    Created: 21 Oct 2026 3:12:40pm
+    Author:  usuario
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <atomic>
+
+// Medidor de carga DSP de esta instancia:
+// 1. processBlock crea un DspLoadMeter::ScopedMeasurement, que mide cuanto tardo el bloque con el reloj de alta resolucion.
+// 2. Esa duracion se divide por la duracion del bloque en tiempo real (numSamples / sampleRate): 1.0 es el 100% del presupuesto.
+// 3. El hilo de audio es el unico que escribe los atomics; el editor los lee desde su timer con readWindow().
+// Un "deadline miss" es un bloque que por si solo tardo mas que su presupuesto.
+struct DspLoadMeter
+{
+    struct Snapshot
+    {
+        float average = 0.0f, minimum = 0.0f, maximum = 0.0f;   // fraccion del presupuesto
+        juce::int64 deadlineMisses = 0;                          // desde prepare()
+        bool valid = false;                                      // false si no hubo bloques en la ventana
+    };
+
+    void prepare(double sampleRate)
+    {
+        ticksPerSample = (double)juce::Time::getHighResolutionTicksPerSecond() / sampleRate;
+
+        loadSum = 0.0;
+        numBlocks = 0;
+        deadlineMisses = 0;
+        resetWindow = true;
+        lastLoadSum = 0.0;
+        lastNumBlocks = 0;
+    }
+
+    struct ScopedMeasurement
+    {
+        ScopedMeasurement(DspLoadMeter& m, int n) noexcept : meter(m), numSamples(n), start(juce::Time::getHighResolutionTicks()) {}
+        ~ScopedMeasurement() noexcept { meter.addBlock(juce::Time::getHighResolutionTicks() - start, numSamples); }
+
+        DspLoadMeter& meter;
+        const int numSamples;
+        const juce::int64 start;
+    };
+
+    // Solo desde el message thread: devuelve min/avg/max desde la llamada anterior
+    Snapshot readWindow()
+    {
+        Snapshot s;
+        const auto blocks = numBlocks.load(std::memory_order_acquire);
+        const auto sum = loadSum.load(std::memory_order_relaxed);
+
+        s.deadlineMisses = deadlineMisses.load(std::memory_order_relaxed);
+
+        if (blocks > lastNumBlocks)
+        {
+            s.average = (float)((sum - lastLoadSum) / (double)(blocks - lastNumBlocks));
+            s.minimum = windowMinimum.load(std::memory_order_relaxed);
+            s.maximum = windowMaximum.load(std::memory_order_relaxed);
+            s.valid = true;
+        }
+
+        lastLoadSum = sum;
+        lastNumBlocks = blocks;
+
+        // El hilo de audio reinicia min/max en el proximo bloque, asi nunca hay dos escritores
+        resetWindow.store(true, std::memory_order_release);
+        return s;
+    }
+
+private:
+    void addBlock(juce::int64 elapsedTicks, int numSamples) noexcept
+    {
+        if (numSamples <= 0 || ticksPerSample <= 0.0)
+            return;
+
+        const auto load = (float)((double)elapsedTicks / (ticksPerSample * numSamples));
+
+        if (resetWindow.exchange(false, std::memory_order_acquire))
+        {
+            windowMinimum.store(load, std::memory_order_relaxed);
+            windowMaximum.store(load, std::memory_order_relaxed);
+        }
+        else
+        {
+            if (load < windowMinimum.load(std::memory_order_relaxed))
+                windowMinimum.store(load, std::memory_order_relaxed);
+            if (load > windowMaximum.load(std::memory_order_relaxed))
+                windowMaximum.store(load, std::memory_order_relaxed);
+        }
+
+        if (load > 1.0f)
+            deadlineMisses.store(deadlineMisses.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+        loadSum.store(loadSum.load(std::memory_order_relaxed) + (double)load, std::memory_order_relaxed);
+        numBlocks.store(numBlocks.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    double ticksPerSample{ 0.0 };
+
+    // Escritos solo por el hilo de audio
+    std::atomic<double> loadSum{ 0.0 };
+    std::atomic<juce::int64> numBlocks{ 0 }, deadlineMisses{ 0 };
+    std::atomic<float> windowMinimum{ 0.0f }, windowMaximum{ 0.0f };
+
+    // Escrito por el lector, consumido por el hilo de audio
+    std::atomic<bool> resetWindow{ true };
+
+    // Estado del lector
+    double lastLoadSum{ 0.0 };
+    juce::int64 lastNumBlocks{ 0 };
+};
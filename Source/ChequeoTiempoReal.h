@@ -0,0 +1,45 @@
+/*
+  ==============================================================================
+
+    ChequeoTiempoReal.h
+    Created: 21 Oct 2026 10:47:03am
+    Author:  usuario
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <atomic>
+
+// Deteccion de allocations y locks en el hilo de audio, solo para builds de prueba.
+// 1. processBlock declara un RealtimeCheck::ScopedAudioThread: mientras vive, el hilo cuenta como hilo de audio.
+// 2. La configuracion RealtimeChecks de SimpleEQRender compila con SIMPLEEQ_REALTIME_CHECKS=1 e instala hooks en malloc/free,
+//    operator new/delete y pthread_mutex_lock que llaman a RealtimeCheck::check().
+// 3. Si check() se llama desde el hilo de audio con los chequeos activos, imprime el stack y aborta.
+// En el plugin y en Debug/Release de SimpleEQRender SIMPLEEQ_REALTIME_CHECKS vale 0 y ScopedAudioThread no hace nada.
+
+#ifndef SIMPLEEQ_REALTIME_CHECKS
+ #define SIMPLEEQ_REALTIME_CHECKS 0
+#endif
+
+namespace RealtimeCheck
+{
+#if SIMPLEEQ_REALTIME_CHECKS
+    inline std::atomic<bool> enabled{ false };
+    inline thread_local int audioThreadDepth = 0;
+
+    // La implementa el ejecutable que instala los hooks
+    void check(const char* what) noexcept;
+
+    struct ScopedAudioThread
+    {
+        ScopedAudioThread() noexcept { ++audioThreadDepth; }
+        ~ScopedAudioThread() noexcept { --audioThreadDepth; }
+    };
+#else
+    struct ScopedAudioThread
+    {
+        ScopedAudioThread() noexcept {}
+    };
+#endif
+}
@@ -10,8 +10,7 @@
 #include "PluginEditor.h"
 
 ResponseCurveComponent::ResponseCurveComponent(SimpleEQAudioProcessor& p) : audioProcessor(p),
-leftPathProducer(audioProcessor.leftChannelFifo),
-rightPathProducer(audioProcessor.rightChannelFifo)
+analyzerClient(audioProcessor, analyzerService->getPlans())
 {
 	const auto& params = audioProcessor.getParameters();
 	for (auto* param : params) {
@@ -20,13 +19,20 @@ rightPathProducer(audioProcessor.rightChannelFifo)
 
 	// Construye la cadena de filtros inicial antes de que se pinte por primera vez
 	updateChain();
+
+	// Desde aca el processor alimenta las FIFOs del analizador (si "Analyzer Enabled" esta prendido)
+	audioProcessor.setAnalyzerEditorOpen(true);
+	analyzerService->add(&analyzerClient);
 		
-	// Inicia el timer para que llame a timerCallback cada 50ms
-	startTimer(50);
+	// Inicia el timer, rapido o lento segun "Analyzer Enabled"
+	updateTimerRate();
 }
 
 ResponseCurveComponent::~ResponseCurveComponent()
 {
+	analyzerService->remove(&analyzerClient);
+	audioProcessor.setAnalyzerEditorOpen(false);
+
 	const auto& params = audioProcessor.getParameters();
 	for (auto* param : params) {
 		param->removeListener(this);
@@ -36,6 +42,7 @@ ResponseCurveComponent::~ResponseCurveComponent()
 void ResponseCurveComponent::paint(juce::Graphics& g)
 {
 	using namespace juce;
+	SIMPLEEQ_TRACE_SCOPE("ResponseCurveComponent::paint");
 
 	g.drawImage(background, getLocalBounds().toFloat());
 
@@ -115,17 +122,21 @@ void ResponseCurveComponent::paint(juce::Graphics& g)
 		responseCurve.lineTo(responseArea.getX() + i, map(mags[i]));
 	}
 
-	// FFT Left Channel
-	auto leftChannelFFTPath = leftPathProducer.getPath();
-	leftChannelFFTPath.applyTransform(AffineTransform().translation(responseArea.getX(), responseArea.getY()));
-	g.setColour(Colours::rebeccapurple);
-	g.strokePath(leftChannelFFTPath, PathStrokeType(1));
+	// Los paths del analizador se dibujan trasladados, sin copiarlos
+	const auto analyzerTransform = AffineTransform::translation(responseArea.getX(), responseArea.getY());
 
-	// FFT Right Channel
-	auto rightChannelFFTPath = rightPathProducer.getPath();
-	rightChannelFFTPath.applyTransform(AffineTransform().translation(responseArea.getX(), responseArea.getY()));
-	g.setColour(Colours::skyblue);
-	g.strokePath(rightChannelFFTPath, PathStrokeType(1));
+	const auto& analyzerFrame = analyzerClient.getFrame();
+
+	// Apagado no se dibuja, aunque el frame vacio todavia no haya llegado
+	if (analyzerTicking) {
+		// FFT Left Channel
+		g.setColour(Colours::rebeccapurple);
+		g.strokePath(analyzerFrame.left, PathStrokeType(1), analyzerTransform);
+
+		// FFT Right Channel
+		g.setColour(Colours::skyblue);
+		g.strokePath(analyzerFrame.right, PathStrokeType(1), analyzerTransform);
+	}
 
 	// Dibujar la curva de respuesta
 	g.setColour(Colours::white);
@@ -137,11 +148,42 @@ void ResponseCurveComponent::paint(juce::Graphics& g)
 	// Dibujar el borde del area de renderizado
 	g.setColour(Colours::rebeccapurple);
 	g.drawRoundedRectangle(getRenderArea().toFloat(), 4.0f, 3.0f);
+
+	paintDspLoad(g);
+}
+
+void ResponseCurveComponent::paintDspLoad(juce::Graphics& g)
+{
+	using namespace juce;
+
+	if (!dspLoad.valid)
+		return;
+
+	String str;
+	str << "DSP " << String(dspLoad.average * 100.0f, 1) << "%"
+		<< "  min " << String(dspLoad.minimum * 100.0f, 1)
+		<< "  max " << String(dspLoad.maximum * 100.0f, 1)
+		<< "  xruns " << dspLoad.deadlineMisses;
+
+	g.setFont(11.0f);
+	auto r = getAnalysisArea().removeFromTop(14).removeFromLeft(g.getCurrentFont().getStringWidth(str) + 8).translated(4, 2);
+
+	g.setColour(Colours::black.withAlpha(0.6f));
+	g.fillRect(r);
+
+	// En rojo si en la ultima ventana algun bloque se paso del presupuesto
+	g.setColour(dspLoadMissedRecently ? Colours::red : Colours::lightgrey);
+	g.drawFittedText(str, r, Justification::centred, 1);
 }
 
 void ResponseCurveComponent::resized()
 {
 	using namespace juce;
+
+	auto fftBounds = getAnalysisArea().toFloat();
+	fftBounds.removeFromRight(9.0f);
+	analyzerClient.setBounds(fftBounds);
+
 	background = Image(Image::PixelFormat::RGB, getWidth(), getHeight(), true);
 
 	Graphics g(background);
@@ -280,87 +322,596 @@ juce::Rectangle<int> ResponseCurveComponent::getAnalysisArea()
 void ResponseCurveComponent::parameterValueChanged(int parameterIndex, float newValue)
 {
 	parametersChanged.set(true);
+
+	// Desde la UI el cambio se aplica enseguida, porque con el analizador apagado el timer es lento.
+	// Si viene de otro hilo (automatizacion del host) lo toma el proximo tick.
+	if (juce::MessageManager::existsAndIsCurrentThread()) {
+		updateTimerRate();
+
+		if (!analyzerTicking)
+			timerCallback();
+	}
 }
 
-void PathProducer::process(juce::Rectangle<float> fftBounds, double sampleRate)
+void ResponseCurveComponent::updateTimerRate()
 {
+	const bool enabled = audioProcessor.isAnalyzerEnabled();
+
+	if (enabled == analyzerTicking && isTimerRunning())
+		return;
+
+	analyzerTicking = enabled;
+	startTimer(enabled ? analyzerTimerMs : idleTimerMs);
+	repaint();
+}
+
+bool PathProducer::process(juce::Rectangle<float> fftBounds, double sampleRate, juce::Path& left, juce::Path& right)
+{
+	SIMPLEEQ_TRACE_SCOPE("PathProducer::process");
+
 	// Logica:
-	// Mientras hayan buffers que pullear desde SingleChannelSimpleFifo se mandan al FFT Data Generator.
-	juce::AudioBuffer<float> tempIncomingBuffer;
+	// 1. Se cuentan los hops completos que hay en las dos SingleChannelSampleFifo. El hop sale del solapamiento
+	//    elegido y no del tamano de bloque del host, asi el costo es el mismo con bloques de 32 o de 2048.
+	// 2. Esas muestras se escriben en stereoBuffer a partir de writePosition (dando la vuelta si hace falta), pisando
+	//    lo mas viejo. Si son mas que fftSize, lo que quedaria pisado dentro de la misma llamada ni se copia.
+	// 3. Se hace una sola FFT (la ventana mas nueva) y un solo par de paths, aunque se hayan acumulado muchos hops:
+	//    despues de un atraso no hay que ponerse al dia con frames que nadie va a ver.
+	// 4. En el modo de doble resolucion todo el audio nuevo, incluso el que se pisa, pasa por el decimador para la banda
+	//    de graves, asi el historial decimado no tiene saltos.
+	const auto requested = resolution.load(std::memory_order_relaxed);
+	const auto dual = requested == resolutionDual && sampleRate > 0.0;
+	const auto order = (requested == resolutionAuto || dual) ? getAutomaticFFTOrder(sampleRate) : (FFTOrder)requested;
+
+	if (dual && (!wasDual || decimator.getSampleRate() != sampleRate))
+	{
+		if (decimator.getSampleRate() != sampleRate)
+			decimator.prepare(sampleRate, dualCrossoverHz);
+
+		resetLowBand();
+	}
+
+	wasDual = dual;
+
+	if (order != fftDataGenerator.getOrder())
+		applyOrder(order);
+
+	if (const auto sm = smoothing.load(std::memory_order_relaxed); sm != fftDataGenerator.getSmoothing())
+		fftDataGenerator.setSmoothing(sm);
 
-	while (leftChannelFifo->getNumCompleteBuffersAvailable() > 0)
+	const auto fftSize = stereoBuffer.getNumSamples();
+	const auto hop = fftSize / (int)overlap.load(std::memory_order_relaxed);
+
+	const auto numAvailable = juce::jmin(leftChannelFifo->getNumSamplesAvailable(), rightChannelFifo->getNumSamplesAvailable());
+	const auto numNewSamples = hop > 0 ? (numAvailable / hop) * hop : 0;
+
+	if (numNewSamples == 0)
+		return false;
+
+	const auto numStale = juce::jmax(0, numNewSamples - fftSize);
+
+	if (dual)
 	{
-		if (leftChannelFifo->getAudioBuffer(tempIncomingBuffer))
+		// Lo que no llega a la FFT larga igual tiene que pasar por el decimador: si se descartara, el historial decimado
+		// tendria un salto. Pasa por stereoBuffer de a tramos de fftSize, que despues pisan las muestras mas nuevas.
+		for (int done = 0; done < numStale;)
 		{
-			auto size = tempIncomingBuffer.getNumSamples();
-
-			juce::FloatVectorOperations::copy(monoBuffer.getWritePointer(0, 0), monoBuffer.getReadPointer(0, size), monoBuffer.getNumSamples() - size);
+			const auto chunk = juce::jmin(fftSize, numStale - done);
 
-			juce::FloatVectorOperations::copy(monoBuffer.getWritePointer(0, monoBuffer.getNumSamples() - size), tempIncomingBuffer.getReadPointer(0, 0), size);
+			if (!writeToHistory(chunk))
+				return false;
 
-			leftChannelFFTDataGenerator.produceFFTDataForRendering(monoBuffer, -60.0f);
+			decimateToLowBand(chunk);
+			done += chunk;
 		}
 	}
+	else
+	{
+		leftChannelFifo->discard(numStale);
+		rightChannelFifo->discard(numStale);
+	}
+
+	if (!writeToHistory(numNewSamples - numStale))
+		return false;
+
+	fftDataGenerator.produceFFTDataForRendering(stereoBuffer, writePosition, -60.0f);
+
+	const auto settings = getBallisticsSettings();
+
+	if (settings.holdSeconds != appliedHoldSeconds)
+	{
+		ballistics.reset();
+		lowBallistics.reset();
+		appliedHoldSeconds = settings.holdSeconds;
+	}
+
+	if (dual)
+		processLowBand(numNewSamples - numStale, sampleRate, settings);
 
 	// Generar Path a partir de los FFT Data
 	// Esta funcion va a generar un Path en los bounds que le pasemos (Segundo argumento de la funcion generatePath())
-	const auto fftSize = leftChannelFFTDataGenerator.getFFTSize();
 	const auto binWidth = sampleRate / (double)fftSize;
+	const auto numBins = fftSize / 2;
 
-	while (leftChannelFFTDataGenerator.getNumAvailableFFTDataBlocks() > 0)
+	// El bloque de FFT (izquierdo y despues derecho) pasa por la balistica, que guarda su estado por bin,
+	// y los paths salen de lo que queda en la balistica
+	if (auto* fftData = fftDataGenerator.acquireFFTData())
 	{
-		std::vector<float> fftData;
-		if (leftChannelFFTDataGenerator.getFFTData(fftData))
+		ballistics.process(fftData->data(), (float)(numNewSamples / sampleRate), settings);
+		fftDataGenerator.releaseFFTData();
+
+		const auto* display = ballistics.getOutput();
+
+		if (dual && lowBandReady)
+		{
+			// Graves de la FFT larga hasta dualCrossoverHz y desde ahi la FFT corta, en el mismo path
+			using Band = AnalyzerPathGenerator<juce::Path>::SpectrumBand;
+			const auto lowFFTSize = lowFFTDataGenerator.getFFTSize();
+			const auto lowBinWidth = (float)(sampleRate / StereoDecimator::factor / (double)lowFFTSize);
+			const auto* low = lowBallistics.getOutput();
+			constexpr auto noLimit = std::numeric_limits<float>::max();
+
+			const Band leftBands[] = { { low, lowFFTSize, lowBinWidth, 0.0f, dualCrossoverHz },
+									   { display, fftSize, (float)binWidth, dualCrossoverHz, noLimit } };
+			const Band rightBands[] = { { low + lowFFTSize / 2, lowFFTSize, lowBinWidth, 0.0f, dualCrossoverHz },
+										{ display + numBins, fftSize, (float)binWidth, dualCrossoverHz, noLimit } };
+
+			leftPathGenerator.generatePath(leftBands, 2, fftBounds, -48.0f);
+			rightPathGenerator.generatePath(rightBands, 2, fftBounds, -48.0f);
+		}
+		else
 		{
-			pathProducer.generatePath(fftData, fftBounds, fftSize, binWidth, -48.0f);
+			leftPathGenerator.generatePath(display, fftBounds, fftSize, binWidth, -48.0f);
+			rightPathGenerator.generatePath(display + numBins, fftBounds, fftSize, binWidth, -48.0f);
 		}
 	}
 
-	// Mientras hayan Paths que se puedan pullear, pullea tantos como podamosy mostramos el mas reciente
-	while (pathProducer.getNumPathsAvailable())
+	// Los Path nuevos van directo a los del llamador (swap, sin copia)
+	const bool newLeft = leftPathGenerator.swapWithNewestPath(left);
+	const bool newRight = rightPathGenerator.swapWithNewestPath(right);
+	return newLeft || newRight;
+}
+
+void PathProducer::applyOrder(FFTOrder order)
+{
+	fftDataGenerator.changeOrder(plans.get(order));
+
+	// Con avoidReallocating el buffer solo cambia de largo dentro de lo que se aloco en el constructor
+	stereoBuffer.setSize(2, fftDataGenerator.getFFTSize(), false, true, true);
+	stereoBuffer.clear();
+	writePosition = 0;
+
+	ballistics.prepare(fftDataGenerator.getFFTSize());
+}
+
+void PathProducer::decimateToLowBand(int numSamples)
+{
+	// Las muestras nuevas son las numSamples anteriores a writePosition (en uno o dos tramos)
+	const auto fftSize = stereoBuffer.getNumSamples();
+	const auto start = (writePosition - numSamples + fftSize) % fftSize;
+	const auto firstPart = juce::jmin(numSamples, fftSize - start);
+
+	lowNewSamples += decimator.process(stereoBuffer.getReadPointer(0, start), stereoBuffer.getReadPointer(1, start), firstPart, lowBuffer, lowWritePosition);
+	lowNewSamples += decimator.process(stereoBuffer.getReadPointer(0), stereoBuffer.getReadPointer(1), numSamples - firstPart, lowBuffer, lowWritePosition);
+}
+
+void PathProducer::processLowBand(int numSamples, double sampleRate, const SpectrumBallistics::Settings& settings)
+{
+	decimateToLowBand(numSamples);
+
+	// La FFT de graves va con el mismo solapamiento, contado en muestras decimadas; como la otra, solo la ventana mas nueva
+	const auto lowHop = lowFFTDataGenerator.getFFTSize() / (int)overlap.load(std::memory_order_relaxed);
+
+	if (lowNewSamples < lowHop)
+		return;
+
+	if (const auto sm = smoothing.load(std::memory_order_relaxed); sm != lowFFTDataGenerator.getSmoothing())
+		lowFFTDataGenerator.setSmoothing(sm);
+
+	lowFFTDataGenerator.produceFFTDataForRendering(lowBuffer, lowWritePosition, -60.0f);
+
+	if (auto* fftData = lowFFTDataGenerator.acquireFFTData())
+	{
+		lowBallistics.process(fftData->data(), (float)(lowNewSamples * StereoDecimator::factor / sampleRate), settings);
+		lowFFTDataGenerator.releaseFFTData();
+		lowBandReady = true;
+	}
+
+	lowNewSamples = 0;
+}
+
+void PathProducer::resetLowBand()
+{
+	decimator.reset();
+	lowBuffer.clear();
+	lowWritePosition = 0;
+	lowNewSamples = 0;
+	lowBandReady = false;
+	lowBallistics.reset();
+}
+
+bool PathProducer::writeToHistory(int numSamples)
+{
+	const auto fftSize = stereoBuffer.getNumSamples();
+	jassert(numSamples <= fftSize);
+
+	const auto firstPart = juce::jmin(numSamples, fftSize - writePosition);
+	const auto secondPart = numSamples - firstPart;
+
+	bool pulled = leftChannelFifo->pull(stereoBuffer.getWritePointer(0, writePosition), firstPart)
+		&& rightChannelFifo->pull(stereoBuffer.getWritePointer(1, writePosition), firstPart);
+
+	if (pulled && secondPart > 0)
+		pulled = leftChannelFifo->pull(stereoBuffer.getWritePointer(0), secondPart)
+			&& rightChannelFifo->pull(stereoBuffer.getWritePointer(1), secondPart);
+
+	if (pulled)
+		writePosition = (writePosition + numSamples) % fftSize;
+
+	return pulled;
+}
+
+//==============================================================================
+AnalyzerClient::AnalyzerClient(SimpleEQAudioProcessor& p, const FFTPlanSet& plans) : audioProcessor(p),
+pathProducer(audioProcessor.leftChannelFifo, audioProcessor.rightChannelFifo, plans)
+{
+}
+
+void AnalyzerClient::setBounds(juce::Rectangle<float> fftBounds)
+{
+	boundsX = fftBounds.getX();
+	boundsY = fftBounds.getY();
+	boundsWidth = fftBounds.getWidth();
+	boundsHeight = fftBounds.getHeight();
+}
+
+void AnalyzerClient::processFrame()
+{
+	const bool enabled = audioProcessor.isAnalyzerEnabled();
+
+	if (enabled != wasEnabled)
+	{
+		// Al apagarlo se publican paths vacios; al prenderlo se tira el audio viejo que quedo en las FIFOs
+		pathProducer.reset();
+
+		auto& frame = frames.getWriteBuffer();
+		frame.left.clear();
+		frame.right.clear();
+		frames.publish();
+
+		wasEnabled = enabled;
+	}
+
+	const juce::Rectangle<float> fftBounds(boundsX.load(), boundsY.load(), boundsWidth.load(), boundsHeight.load());
+
+	if (!enabled || fftBounds.isEmpty())
+		return;
+
+	const auto sampleRate = audioProcessor.getSampleRate();
+
+	// Los paths se generan en el slot de escritura del triple buffer: publicar no copia ni aloca
+	auto& frame = frames.getWriteBuffer();
+
+	if (pathProducer.process(fftBounds, sampleRate, frame.left, frame.right))
+		frames.publish();
+}
+
+//==============================================================================
+AnalyzerService::AnalyzerService() : juce::Thread("SimpleEQ analyzer service"),
+numWorkers(juce::jlimit(1, 4, juce::SystemStats::getNumCpus() / 4)),
+pool(juce::ThreadPoolOptions{}
+	.withThreadName("SimpleEQ analyzer")
+	.withNumberOfThreads(numWorkers)
+	.withDesiredThreadPriority(juce::Thread::Priority::low))
+{
+	startThread(juce::Thread::Priority::low);
+}
+
+AnalyzerService::~AnalyzerService()
+{
+	stopThread(1000);
+
+	// Altas que el hilo no llego a aplicar (las bajas siempre se esperan, asi que no queda ninguna)
+	for (auto* change = pendingChanges.exchange(nullptr); change != nullptr;)
 	{
-		pathProducer.getPath(leftChannelFFTPath);
+		auto* next = change->next;
+		delete change;
+		change = next;
 	}
 }
 
+void AnalyzerService::add(AnalyzerClient* client)
+{
+	pushChange(new PendingChange{ client, true, nullptr, nullptr });
+}
+
+void AnalyzerService::remove(AnalyzerClient* client)
+{
+	juce::WaitableEvent applied;
+	pushChange(new PendingChange{ client, false, &applied, nullptr });
+
+	// Sin esto el servicio recien lo veria despues de su wait() entre frames
+	notify();
+	applied.wait();
+}
+
+void AnalyzerService::pushChange(PendingChange* change)
+{
+	change->next = pendingChanges.load(std::memory_order_relaxed);
+
+	while (!pendingChanges.compare_exchange_weak(change->next, change, std::memory_order_release, std::memory_order_relaxed))
+	{
+	}
+}
+
+void AnalyzerService::applyPendingChanges()
+{
+	// Se saca la pila entera de una vez (un solo consumidor, asi que no hay ABA) y se invierte para aplicar en orden
+	PendingChange* change = nullptr;
+
+	for (auto* head = pendingChanges.exchange(nullptr, std::memory_order_acquire); head != nullptr;)
+	{
+		auto* next = head->next;
+		head->next = change;
+		change = head;
+		head = next;
+	}
+
+	while (change != nullptr)
+	{
+		if (change->adding)
+			clients.addIfNotAlreadyThere(change->client);
+		else
+			clients.removeFirstMatchingValue(change->client);
+
+		// Despues de signal() el evento puede dejar de existir (es del stack de remove())
+		auto* applied = change->applied;
+		auto* next = change->next;
+		delete change;
+		change = next;
+
+		if (applied != nullptr)
+			applied->signal();
+	}
+
+	// Los vectores del frame se agrandan aca, entre frames, y no en cada frame
+	const auto numClients = (size_t)clients.size();
+	frameClients.reserve(numClients);
+	schedule.reserve(numClients);
+	done.resize(juce::jmax(done.size(), numClients));
+	batches.resize((size_t)numWorkers);
+
+	for (auto& batch : batches)
+		batch.reserve(numClients);
+}
+
+void AnalyzerService::run()
+{
+	Trace::Recorder::nameCurrentThread("Analyzer service");
+
+	while (!threadShouldExit())
+	{
+		const auto frameStart = juce::Time::getMillisecondCounterHiRes();
+		applyPendingChanges();
+		processFrame();
+
+		const auto elapsed = juce::Time::getMillisecondCounterHiRes() - frameStart;
+		wait(juce::jmax(1, framePeriodMs - (int)elapsed));
+	}
+}
+
+void AnalyzerService::processFrame()
+{
+	SIMPLEEQ_TRACE_SCOPE("AnalyzerService::processFrame");
+
+	// La lista de clientes solo cambia entre frames (applyPendingChanges), asi que el frame la usa sin locks.
+	// Orden rotado, empezando por nextClient (el primero que no llego el frame anterior).
+	const auto numClients = clients.size();
+	if (numClients == 0)
+		return;
+
+	frameClients.clear();
+	for (int p = 0; p < numClients; ++p)
+		frameClients.push_back(clients.getUnchecked((nextClient + p) % numClients));
+
+	// Agrupados por orden de FFT (la misma ventana seguida), pero los grupos tambien siguen la rotacion:
+	// primero el grupo del primer cliente rotado y dentro de cada grupo el orden rotado. Asi un cliente con una FFT
+	// mas grande que se quedo sin tiempo encabeza el frame siguiente en vez de quedar siempre al final de su lote.
+	std::array<int, order8192 + 1> groupRank;
+	groupRank.fill(-1);
+	int numGroups = 0;
+
+	for (auto* client : frameClients)
+		if (auto& rank = groupRank[(size_t)client->getOrder()]; rank < 0)
+			rank = numGroups++;
+
+	schedule.clear();
+	for (int group = 0; group < numGroups; ++group)
+		for (int p = 0; p < numClients; ++p)
+			if (groupRank[(size_t)frameClients[(size_t)p]->getOrder()] == group)
+				schedule.push_back(p);
+
+	// Se reparten intercalados: cada lote conserva los grupos y el principio de la rotacion va primero en todos
+	const auto numBatches = juce::jmin(numWorkers, numClients);
+	for (int b = 0; b < numBatches; ++b)
+		batches[(size_t)b].clear();
+
+	for (int s = 0; s < numClients; ++s)
+		batches[(size_t)(s % numBatches)].push_back(schedule[(size_t)s]);
+
+	std::fill(done.begin(), done.begin() + numClients, (char)0);
+
+	const auto deadline = juce::Time::getMillisecondCounterHiRes() + frameBudgetMs;
+	std::atomic<int> pendingBatches{ numBatches };
+	juce::WaitableEvent allDone;
+
+	for (int b = 0; b < numBatches; ++b)
+	{
+		pool.addJob([this, &batch = batches[(size_t)b], &pendingBatches, &allDone, deadline]
+			{
+				for (auto p : batch)
+				{
+					if (juce::Time::getMillisecondCounterHiRes() > deadline)
+						break;
+
+					frameClients[(size_t)p]->processFrame();
+					done[(size_t)p] = 1;
+				}
+
+				if (--pendingBatches == 0)
+					allDone.signal();
+			});
+	}
+
+	allDone.wait();
+
+	// El proximo frame empieza por el primer cliente (en orden rotado) que se quedo sin tiempo; si llegaron todos, se rota uno
+	int firstSkipped = numClients;
+	for (int p = 0; p < numClients; ++p)
+		if (done[(size_t)p] == 0)
+		{
+			firstSkipped = p;
+			break;
+		}
+
+	nextClient = (nextClient + (firstSkipped < numClients ? firstSkipped : 1)) % numClients;
+}
+
 void ResponseCurveComponent::timerCallback()
 {
-	auto fftBounds = getAnalysisArea().toFloat();
-	fftBounds.removeFromRight(9.0f);
-	auto sampleRate = audioProcessor.getSampleRate();
+	// "Analyzer Enabled" tambien puede cambiar por automatizacion: el tick lento lo detecta
+	updateTimerRate();
 
-	leftPathProducer.process(fftBounds, sampleRate);
-	rightPathProducer.process(fftBounds, sampleRate);
+	// El FFT corre en el AnalyzerService: aca solo se toma el frame mas nuevo, si hay uno.
+	// Con el analizador apagado no llegan frames y solo se repinta si algo cambio.
+	bool needsRepaint = analyzerClient.acquireLatestFrame();
+
+	if (const auto now = juce::Time::getMillisecondCounter(); now - lastDspLoadRead >= dspLoadReadIntervalMs)
+	{
+		lastDspLoadRead = now;
+		dspLoad = audioProcessor.dspLoadMeter.readWindow();
+		dspLoadMissedRecently = dspLoad.deadlineMisses > lastDeadlineMisses;
+		lastDeadlineMisses = dspLoad.deadlineMisses;
+		needsRepaint = true;
+	}
 
 	if (parametersChanged.compareAndSetBool(false, true))
 	{
 		// Si los parametros han cambiado (true), actualizamos la cadena y repintamos y parametrosChanged a false
 		updateChain();
-		// repaint(); Ahora hay que repintar todo el rato (FFT Analyzer), no solo cuando cambien parametros.
+		needsRepaint = true;
 	}
 
-	repaint();
+	if (needsRepaint)
+		repaint();
 }
 
-void ResponseCurveComponent::updateChain() {
-	auto chainSettings = getChainSettings(audioProcessor.apvts);
+void ResponseCurveComponent::mouseDown(const juce::MouseEvent& e)
+{
+	if (!e.mods.isPopupMenu())
+		return;
+
+	juce::PopupMenu menu;
+
+	juce::PopupMenu overlapMenu;
+	const auto currentOverlap = analyzerClient.getOverlap();
+
+	for (auto [overlap, name] : { std::pair{ overlapNone, "0%" }, std::pair{ overlapHalf, "50%" }, std::pair{ overlapThreeQuarters, "75%" } })
+	{
+		overlapMenu.addItem(name, true, overlap == currentOverlap, [safeThis = juce::Component::SafePointer<ResponseCurveComponent>(this), o = overlap]
+			{
+				if (safeThis != nullptr)
+					safeThis->analyzerClient.setOverlap(o);
+			});
+	}
 
-	// Chequear si algun filtro esta bypassed
-	monoChain.setBypassed<ChainPositions::Peak>(chainSettings.peakBypassed);
-	monoChain.setBypassed<ChainPositions::LowCut>(chainSettings.lowCutBypassed);
-	monoChain.setBypassed<ChainPositions::HighCut>(chainSettings.highCutBypassed);
+	menu.addSubMenu("Solapamiento del analizador", overlapMenu);
 
-	// Actualizar los coeficientes del filtro peak
-	auto peakCoefficients = makePeakFilter(chainSettings, audioProcessor.getSampleRate());
-	updateCoefficients(monoChain.get<ChainPositions::Peak>().coefficients, peakCoefficients);
+	juce::PopupMenu resolutionMenu;
+	const auto currentResolution = analyzerClient.getResolution();
+	const auto automaticSize = 1 << getAutomaticFFTOrder(audioProcessor.getSampleRate());
 
-	// Actualizar los coeficientes de los filtros low cut y high cut
-	auto lowCutCoefficients = makeLowCutFilter(chainSettings, audioProcessor.getSampleRate());
-	auto highCutCoefficients = makeHighCutFilter(chainSettings, audioProcessor.getSampleRate());
+	for (auto [resolution, name] : { std::pair{ resolutionAuto, "Automatica (" + juce::String(automaticSize) + " puntos)" },
+									 std::pair{ resolutionDual, juce::String("Doble resolucion (graves con 16384 puntos)") },
+									 std::pair{ resolution2048, juce::String("2048 puntos") },
+									 std::pair{ resolution4096, juce::String("4096 puntos") },
+									 std::pair{ resolution8192, juce::String("8192 puntos") } })
+	{
+		resolutionMenu.addItem(name, true, resolution == currentResolution, [safeThis = juce::Component::SafePointer<ResponseCurveComponent>(this), r = resolution]
+			{
+				if (safeThis != nullptr)
+					safeThis->analyzerClient.setResolution(r);
+			});
+	}
+
+	menu.addSubMenu("Resolucion del analizador", resolutionMenu);
 
-	updateCutFilter(monoChain.get<ChainPositions::LowCut>(), lowCutCoefficients, chainSettings.lowCutSlope);
-	updateCutFilter(monoChain.get<ChainPositions::HighCut>(), highCutCoefficients, chainSettings.highCutSlope);
+	juce::PopupMenu smoothingMenu;
+	const auto currentSmoothing = analyzerClient.getSmoothing();
+
+	for (auto [smoothing, name] : { std::pair{ smoothingNone, "Sin suavizado" },
+									std::pair{ smoothingThirdOctave, "1/3 de octava" },
+									std::pair{ smoothingSixthOctave, "1/6 de octava" },
+									std::pair{ smoothingTwelfthOctave, "1/12 de octava" },
+									std::pair{ smoothingTwentyFourthOctave, "1/24 de octava" } })
+	{
+		smoothingMenu.addItem(name, true, smoothing == currentSmoothing, [safeThis = juce::Component::SafePointer<ResponseCurveComponent>(this), sm = smoothing]
+			{
+				if (safeThis != nullptr)
+					safeThis->analyzerClient.setSmoothing(sm);
+			});
+	}
+
+	menu.addSubMenu("Suavizado del analizador", smoothingMenu);
+
+	// Promedio, retencion de picos y caida: cada opcion es un valor para el setter correspondiente
+	const auto ballistics = analyzerClient.getBallisticsSettings();
+	constexpr auto infinite = std::numeric_limits<float>::infinity();
+
+	auto addOptions = [this](juce::PopupMenu& subMenu, float currentValue, void (AnalyzerClient::*setter)(float),
+							 std::initializer_list<std::pair<float, const char*>> options)
+		{
+			for (const auto& [value, name] : options)
+			{
+				subMenu.addItem(name, true, value == currentValue, [safeThis = juce::Component::SafePointer<ResponseCurveComponent>(this), setter, v = value]
+					{
+						if (safeThis != nullptr)
+							(safeThis->analyzerClient.*setter)(v);
+					});
+			}
+		};
+
+	juce::PopupMenu averagingMenu, holdMenu, decayMenu;
+	addOptions(averagingMenu, ballistics.averagingSeconds, &AnalyzerClient::setAveragingSeconds,
+			   { { 0.0f, "Sin promedio" }, { 0.1f, "100 ms" }, { 0.3f, "300 ms" }, { 1.0f, "1 s" } });
+	addOptions(holdMenu, ballistics.holdSeconds, &AnalyzerClient::setHoldSeconds,
+			   { { 0.0f, "Sin retencion" }, { 1.0f, "1 s" }, { 3.0f, "3 s" }, { infinite, "Infinita" } });
+	addOptions(decayMenu, ballistics.decayDecibelsPerSecond, &AnalyzerClient::setDecayDecibelsPerSecond,
+			   { { infinite, "Instantanea" }, { 60.0f, "60 dB/s" }, { 20.0f, "20 dB/s" }, { 6.0f, "6 dB/s" } });
+
+	menu.addSubMenu("Promedio del analizador", averagingMenu);
+	menu.addSubMenu("Retencion de picos", holdMenu);
+	menu.addSubMenu("Caida del analizador", decayMenu);
+	menu.addItem(audioProcessor.traceRecorder->isRecording() ? "Detener traza" : "Grabar traza (Chrome/Perfetto)", []
+		{
+			// El menu es asincronico: se vuelve a pedir el recorder por si el editor ya no existe
+			juce::SharedResourcePointer<Trace::Recorder> recorder;
+
+			if (recorder->isRecording())
+				recorder->stop();
+			else
+				recorder->start(juce::File::getSpecialLocation(juce::File::userDocumentsDirectory)
+					.getChildFile("SimpleEQ")
+					.getNonexistentChildFile("traza", ".json"));
+		});
+
+	menu.showMenuAsync(juce::PopupMenu::Options().withTargetComponent(this));
+}
+
+void ResponseCurveComponent::updateChain() {
+	auto chainSettings = getChainSettings(audioProcessor.apvts);
 
+	// Bypass y coeficientes de los tres filtros, igual que en el processor
+	updateMonoChain(monoChain, chainSettings, audioProcessor.getSampleRate());
 }
 
 //==============================================================================
@@ -77,27 +77,206 @@ struct MyLookAndFeel : juce::LookAndFeel_V4
 	}
 };
 
+// Analizador de los dos canales: cada frame con audio nuevo en las dos FIFOs produce una sola FFT compleja
+// (StereoFFTDataGenerator) de la que salen los dos espectros y los dos paths.
+// En el modo de doble resolucion los graves salen ademas de una FFT sobre la senal decimada.
 struct PathProducer
 {
-    PathProducer(SingleChannelSampleFifo<SimpleEQAudioProcessor::BlockType>& scsf) : leftChannelFifo(&scsf)
+    using Fifo = SingleChannelSampleFifo<SimpleEQAudioProcessor::BlockType>;
+
+    PathProducer(Fifo& left, Fifo& right, const FFTPlanSet& planSet) : leftChannelFifo(&left), rightChannelFifo(&right), plans(planSet)
     {
-        leftChannelFFTDataGenerator.changeOrder(FFTOrder::order2048);
-        monoBuffer.setSize(1, leftChannelFFTDataGenerator.getFFTSize());
-	}
+        // Todo se aloca aca para el orden mas grande; cambiar de orden despues no aloca
+        fftDataGenerator.preallocate(FFTOrder::order8192);
+        ballistics.reserve(1 << FFTOrder::order8192);
+        stereoBuffer.setSize(2, 1 << FFTOrder::order8192);
+        applyOrder(FFTOrder::order2048);
+
+        lowFFTDataGenerator.preallocate(FFTOrder::order2048);
+        lowFFTDataGenerator.changeOrder(plans.get(FFTOrder::order2048));
+        lowBuffer.setSize(2, lowFFTDataGenerator.getFFTSize());
+        lowBallistics.prepare(lowFFTDataGenerator.getFFTSize());
+        resetLowBand();
+    }
+
+    // Desde cualquier hilo; se aplican en el proximo process()
+    void setOverlap(AnalyzerOverlap o) { overlap.store(o, std::memory_order_relaxed); }
+    AnalyzerOverlap getOverlap() const { return overlap.load(std::memory_order_relaxed); }
+    void setResolution(AnalyzerResolution r) { resolution.store(r, std::memory_order_relaxed); }
+    AnalyzerResolution getResolution() const { return resolution.load(std::memory_order_relaxed); }
+    void setSmoothing(AnalyzerSmoothing sm) { smoothing.store(sm, std::memory_order_relaxed); }
+    AnalyzerSmoothing getSmoothing() const { return smoothing.load(std::memory_order_relaxed); }
+
+    // Promedio, retencion de picos y caida (ver SpectrumBallistics); cambiar la retencion borra los picos retenidos
+    void setAveragingSeconds(float seconds) { averagingSeconds.store(seconds, std::memory_order_relaxed); }
+    void setHoldSeconds(float seconds) { holdSeconds.store(seconds, std::memory_order_relaxed); }
+    void setDecayDecibelsPerSecond(float rate) { decayDecibelsPerSecond.store(rate, std::memory_order_relaxed); }
+    SpectrumBallistics::Settings getBallisticsSettings() const
+    {
+        return { averagingSeconds.load(std::memory_order_relaxed),
+                 holdSeconds.load(std::memory_order_relaxed),
+                 decayDecibelsPerSecond.load(std::memory_order_relaxed) };
+    }
+
+    // Devuelve true si se generaron paths nuevos. Como mucho una FFT por llamada, con la ventana mas nueva:
+    // si se acumulo mas audio (por ejemplo porque el servicio se atraso), los frames intermedios no se calculan.
+    // Los paths nuevos se intercambian con left y right (sin copia); lo que tenian vuelve a los generadores para reusarse.
+    bool process(juce::Rectangle<float> fftBounds, double sampleRate, juce::Path& left, juce::Path& right);
+    FFTOrder getOrder() const { return fftDataGenerator.getOrder(); }
+
+    // Descarta lo pendiente en las FIFOs y el historial
+    void reset()
+    {
+        leftChannelFifo->discardAll();
+        rightChannelFifo->discardAll();
+        ballistics.reset();
+        resetLowBand();
+    }
+
+private:
+    Fifo* leftChannelFifo;
+    Fifo* rightChannelFifo;
+
+    // Historial circular de los dos canales: writePosition es donde va la muestra siguiente (y a la vez la mas vieja)
+    juce::AudioBuffer<float> stereoBuffer;
+    int writePosition = 0;
+    std::atomic<AnalyzerOverlap> overlap{ overlapThreeQuarters };
+    std::atomic<AnalyzerResolution> resolution{ resolutionAuto };
+    std::atomic<AnalyzerSmoothing> smoothing{ smoothingNone };
+    std::atomic<float> averagingSeconds{ 0.0f }, holdSeconds{ 0.0f };
+    std::atomic<float> decayDecibelsPerSecond{ std::numeric_limits<float>::infinity() };
+    float appliedHoldSeconds = 0.0f;
+
+    const FFTPlanSet& plans;
+
+    StereoFFTDataGenerator<std::vector<float>> fftDataGenerator;
+    SpectrumBallistics ballistics;     // los dos canales juntos, con el mismo formato que los slots del generador
+
+    // Banda de graves del modo de doble resolucion: la senal decimada (StereoDecimator) en su propio historial
+    // circular, con su FFT de 2048 puntos y su balistica. Por debajo de dualCrossoverHz el path sale de aca.
+    static constexpr float dualCrossoverHz = 500.0f;
+    StereoDecimator decimator;
+    juce::AudioBuffer<float> lowBuffer;
+    int lowWritePosition = 0, lowNewSamples = 0;
+    bool lowBandReady = false, wasDual = false;
+    StereoFFTDataGenerator<std::vector<float>> lowFFTDataGenerator;
+    SpectrumBallistics lowBallistics;
+
+    AnalyzerPathGenerator<juce::Path> leftPathGenerator, rightPathGenerator;
+
+    // Pasa numSamples (<= fftSize) de las dos FIFOs al historial circular
+    bool writeToHistory(int numSamples);
+    // Cambia el plan de la FFT y empieza el historial de cero, sin alocar. Las FIFOs de audio no se tocan.
+    void applyOrder(FFTOrder order);
+    // Pasa las numSamples muestras recien escritas en stereoBuffer por el decimador
+    void decimateToLowBand(int numSamples);
+    // Lo mismo y, si se junto un hop de muestras decimadas, hace la FFT de graves
+    void processLowBand(int numSamples, double sampleRate, const SpectrumBallistics::Settings& settings);
+    void resetLowBand();
+};
+
+// Lo que el analizador le entrega al editor, listo para dibujar
+struct AnalyzerFrame
+{
+    juce::Path left, right;
+};
 
-    void process(juce::Rectangle<float> fftBounds, double sampleRate);
-    juce::Path getPath() { return leftChannelFFTPath; }
+// El analizador de un editor: su PathProducer, los bounds y el ultimo frame publicado.
+// El trabajo lo hace el AnalyzerService; el editor solo toma el frame mas nuevo y dibuja.
+class AnalyzerClient
+{
+public:
+    AnalyzerClient(SimpleEQAudioProcessor& p, const FFTPlanSet& plans);
+
+    // Desde resized()
+    void setBounds(juce::Rectangle<float> fftBounds);
+
+    // Solo desde el message thread
+    bool acquireLatestFrame() { return frames.acquireLatest(); }
+    const AnalyzerFrame& getFrame() const { return frames.getReadBuffer(); }
+
+    // Solo desde el AnalyzerService, que nunca procesa el mismo cliente en dos hilos a la vez
+    void processFrame();
+    FFTOrder getOrder() const { return pathProducer.getOrder(); }
+
+    // Desde cualquier hilo
+    void setOverlap(AnalyzerOverlap o) { pathProducer.setOverlap(o); }
+    AnalyzerOverlap getOverlap() const { return pathProducer.getOverlap(); }
+    void setResolution(AnalyzerResolution r) { pathProducer.setResolution(r); }
+    AnalyzerResolution getResolution() const { return pathProducer.getResolution(); }
+    void setSmoothing(AnalyzerSmoothing sm) { pathProducer.setSmoothing(sm); }
+    AnalyzerSmoothing getSmoothing() const { return pathProducer.getSmoothing(); }
+    void setAveragingSeconds(float seconds) { pathProducer.setAveragingSeconds(seconds); }
+    void setHoldSeconds(float seconds) { pathProducer.setHoldSeconds(seconds); }
+    void setDecayDecibelsPerSecond(float rate) { pathProducer.setDecayDecibelsPerSecond(rate); }
+    SpectrumBallistics::Settings getBallisticsSettings() const { return pathProducer.getBallisticsSettings(); }
 
 private:
-    SingleChannelSampleFifo<SimpleEQAudioProcessor::BlockType>* leftChannelFifo;
+    SimpleEQAudioProcessor& audioProcessor;
+    PathProducer pathProducer;
+    LatestValueSlot<AnalyzerFrame> frames;
+
+    std::atomic<float> boundsX{ 0.0f }, boundsY{ 0.0f }, boundsWidth{ 0.0f }, boundsHeight{ 0.0f };
+    bool wasEnabled{ false };
+};
+
+// Un solo servicio por proceso (SharedResourcePointer) para todos los editores abiertos:
+// 1. Tiene los FFTPlan (ventanas) de todos los ordenes, inmutables, compartidos por todos los clientes.
+//    Las FFT son de cada cliente, asi los workers no comparten el lock interno de juce::dsp::FFT.
+// 2. Cada framePeriodMs reparte los clientes entre un pool chico de hilos de baja prioridad.
+//    Dentro de cada hilo los clientes se ordenan por orden de FFT, asi se usa seguida la misma ventana.
+// 3. El frame tiene un presupuesto de frameBudgetMs: los clientes que no llegan quedan primeros en el frame siguiente.
+class AnalyzerService : private juce::Thread
+{
+public:
+    AnalyzerService();
+    ~AnalyzerService() override;
 
-    juce::AudioBuffer<float> monoBuffer;
+    const FFTPlanSet& getPlans() const { return plans; }
 
-    FFTDataGenerator<std::vector<float>> leftChannelFFTDataGenerator;
+    // Desde el message thread. Ninguna de las dos toma locks del servicio: dejan el pedido en una lista sin locks que el
+    // hilo del servicio aplica entre frames. remove() despierta al servicio y espera a que aplique el pedido, o sea
+    // como mucho a que termine el frame en curso; despues de eso el cliente nunca mas se procesa.
+    void add(AnalyzerClient* client);
+    void remove(AnalyzerClient* client);
 
-    AnalyzerPathGenerator<juce::Path> pathProducer;
+private:
+    static constexpr int framePeriodMs = 20;
+    static constexpr double frameBudgetMs = 12.0;
+
+    const FFTPlanSet plans;
 
-    juce::Path leftChannelFFTPath;
+    // Pedido de alta o baja: pila de Treiber, la llenan add()/remove() y la vacia entera el hilo del servicio
+    struct PendingChange
+    {
+        AnalyzerClient* client;
+        bool adding;
+        juce::WaitableEvent* applied;   // solo en las bajas; se senala cuando el cliente ya salio de la lista
+        PendingChange* next;
+    };
+
+    std::atomic<PendingChange*> pendingChanges{ nullptr };
+
+    // Solo desde el hilo del servicio
+    juce::Array<AnalyzerClient*> clients;
+    int nextClient = 0;
+
+    // Del frame en curso, dimensionados al aplicar las altas: los clientes en orden rotado, sus posiciones agrupadas
+    // por orden de FFT, el lote de cada worker y que posiciones se procesaron (cada lote escribe solo las suyas)
+    std::vector<AnalyzerClient*> frameClients;
+    std::vector<int> schedule;
+    std::vector<std::vector<int>> batches;
+    std::vector<char> done;
+
+    const int numWorkers;
+    juce::ThreadPool pool;
+
+    void run() override;
+    void pushChange(PendingChange* change);
+    void applyPendingChanges();
+    void processFrame();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AnalyzerService)
 };
 
 struct ResponseCurveComponent : juce::Component,
@@ -116,6 +295,9 @@ struct ResponseCurveComponent : juce::Component,
 	// Funcion proveniente de Timer
 	void timerCallback() override;
 
+	// Click derecho: menu para grabar una traza (ver Trazas.h)
+	void mouseDown(const juce::MouseEvent& e) override;
+
 private:
     SimpleEQAudioProcessor& audioProcessor;
 
@@ -129,7 +311,24 @@ private:
 	juce::Rectangle<int> getRenderArea();
 	juce::Rectangle<int> getAnalysisArea(); // Area donde las lineas de gain se dibujan, mas chicas que el area total del componente, para que no choque con los limites
 
-	PathProducer leftPathProducer, rightPathProducer;
+	juce::SharedResourcePointer<AnalyzerService> analyzerService;
+	AnalyzerClient analyzerClient;
+
+	// Con el analizador prendido el timer toma frames a 20 Hz. Apagado solo queda un tick lento para la carga DSP
+	// y los parametros automatizados; updateTimerRate() pasa de uno a otro.
+	static constexpr int analyzerTimerMs = 50, idleTimerMs = 500;
+	bool analyzerTicking{ false };
+
+	void updateTimerRate();
+
+	// Overlay de carga DSP: se lee cada dspLoadReadIntervalMs para que el texto sea legible
+	static constexpr juce::uint32 dspLoadReadIntervalMs = 500;
+	juce::uint32 lastDspLoadRead{ 0 };
+	DspLoadMeter::Snapshot dspLoad;
+	juce::int64 lastDeadlineMisses{ 0 };
+	bool dspLoadMissedRecently{ false };
+
+	void paintDspLoad(juce::Graphics& g);
 
 };
 
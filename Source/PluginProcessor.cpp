@@ -8,6 +8,7 @@
 
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
+#include "ChequeoTiempoReal.h"
 
 //==============================================================================
 SimpleEQAudioProcessor::SimpleEQAudioProcessor()
@@ -22,6 +23,13 @@ SimpleEQAudioProcessor::SimpleEQAudioProcessor()
                        )
 #endif
 {
+	// Los filtros arrancan con coeficientes de primer orden: les damos lugar para un biquad una sola vez,
+	// asi despues los coeficientes se actualizan en el lugar sin alocar en el hilo de audio.
+	for (auto* chain : { &leftChain, &rightChain })
+		prepareCoefficientStorage(*chain);
+
+	for (auto* chain : { &leftChainHQ, &rightChainHQ })
+		prepareCoefficientStorage(*chain);
 }
 
 SimpleEQAudioProcessor::~SimpleEQAudioProcessor()
@@ -106,8 +114,28 @@ void SimpleEQAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBloc
 
 	updateFilters();
 
+	// Cadena offline de alta calidad: se prepara siempre para que pasar de un modo a otro nunca aloque
+	leftChainHQ.prepare(spec);
+	rightChainHQ.prepare(spec);
+	highQualityBuffer.setSize(2, samplesPerBlock);
+
+	for (auto* smoother : { &smoothedLowCutFreq, &smoothedHighCutFreq, &smoothedPeakFreq, &smoothedPeakQuality })
+		smoother->reset(sampleRate, 0.02);
+	smoothedPeakGain.reset(sampleRate, 0.02);
+
+	crossfadeLength = juce::jmax(1, juce::roundToInt(sampleRate * 0.02));
+	settleLength = juce::roundToInt(sampleRate * 0.5);
+
+	// Recien preparado no hay estado que conservar: se arranca directo en el modo que pide el host
+	highQualityActive = isNonRealtime();
+	resetIncomingChain(highQualityActive);
+	settleSamplesRemaining = 0;
+	crossfadeSamplesRemaining = 0;
+
 	leftChannelFifo.prepare(samplesPerBlock);
     rightChannelFifo.prepare(samplesPerBlock);
+
+	dspLoadMeter.prepare(sampleRate);
 }
 
 void SimpleEQAudioProcessor::releaseResources()
@@ -143,6 +171,9 @@ bool SimpleEQAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts)
 #endif
 
 void SimpleEQAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) {
+    RealtimeCheck::ScopedAudioThread realtimeScope;
+    DspLoadMeter::ScopedMeasurement loadMeasurement(dspLoadMeter, buffer.getNumSamples());
+    SIMPLEEQ_TRACE_SCOPE("processBlock");
     juce::ScopedNoDenormals noDenormals;
     auto totalNumInputChannels  = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
@@ -156,24 +187,104 @@ void SimpleEQAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juc
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear (i, 0, buffer.getNumSamples());
     
-	// Aca es donde se actualizan los coeficientes en tiempo real, para que el filtro responda a los cambios de los parametros. Se hace antes de procesar el audio.
-	updateFilters();
+	const auto numSamples = buffer.getNumSamples();
+	const auto numChannels = juce::jmin(2, buffer.getNumChannels());
+	Trace::Recorder::counter("Block size", numSamples);
+
+	if (getSampleRate() != loggedSampleRate) {
+		realtimeLog.log(LogLevel::Info, "Sample rate: {} Hz (antes {} Hz), bloque de {} muestras", { getSampleRate(), loggedSampleRate, (double)numSamples });
+		loggedSampleRate = getSampleRate();
+	}
+
+	const auto inputFinite = checkInput(buffer, numChannels, numSamples);
+
+	// Las cadenas van en tramos del tamano de highQualityBuffer: algunos hosts mandan bloques mas grandes
+	// que los anunciados en prepareToPlay, y aca no se puede alocar
+	const auto sliceSize = highQualityBuffer.getNumSamples();
+	jassert(sliceSize > 0);
+
+	for (int start = 0; sliceSize > 0 && start < numSamples; start += sliceSize)
+		processRenderModes(buffer, start, juce::jmin(sliceSize, numSamples - start), numChannels);
+
+	checkFilterState(buffer, numChannels, numSamples, inputFinite);
+
+	// Aca se actualizan los buffers de audio FIFO, solo si alguien los va a leer
+	if (isAnalyzerTapActive()) {
+		SIMPLEEQ_TRACE_SCOPE("FIFO push");
+		leftChannelFifo.update(buffer);
+		rightChannelFifo.update(buffer);
+	}
+
+	logAnalyzerDrops();
+}
+
+bool SimpleEQAudioProcessor::checkInput(const juce::AudioBuffer<float>& buffer, int numChannels, int numSamples) {
+	// x * 0 es 0 para todo x finito y NaN para NaN o inf: la suma queda en 0 solo si todo el bloque es finito,
+	// con un loop sin saltos.
+	int firstNonFinite = -1;
+
+	for (int ch = 0; ch < numChannels && firstNonFinite < 0; ++ch) {
+		const auto* data = buffer.getReadPointer(ch);
+		float sum = 0.0f;
+
+		for (int i = 0; i < numSamples; ++i)
+			sum += data[i] * 0.0f;
+
+		if (sum != 0.0f)
+			firstNonFinite = ch;
+	}
+
+	const bool finite = firstNonFinite < 0;
+
+	if (!finite && !nonFiniteInput)
+		realtimeLog.log(LogLevel::Warning, "Entrada no finita (NaN o inf) en el canal {}", { (double)firstNonFinite });
+	else if (finite && nonFiniteInput)
+		realtimeLog.log(LogLevel::Info, "La entrada volvio a ser finita");
+
+	nonFiniteInput = !finite;
+	return finite;
+}
 
-   // Procesamiento despues de actualizar valores
-	juce::dsp::AudioBlock<float> block(buffer);
+void SimpleEQAudioProcessor::checkFilterState(const juce::AudioBuffer<float>& buffer, int numChannels, int numSamples, bool inputFinite) {
+	if (numSamples == 0)
+		return;
 
-    auto leftBlock = block.getSingleChannelBlock(0);
-	auto rightBlock = block.getSingleChannelBlock(1);
+	// Un NaN o inf en el estado de un IIR se propaga a todas las muestras siguientes: alcanza con mirar la ultima.
+	// Con la entrada no finita la salida tambien lo es y ya se aviso en checkInput; eso no dice nada del estado.
+	int channel = -1;
 
-    juce::dsp::ProcessContextReplacing<float> leftContext(leftBlock);
-	juce::dsp::ProcessContextReplacing<float> rightContext(rightBlock);
-   
-	leftChain.process(leftContext);
-	rightChain.process(rightContext);
+	for (int ch = 0; ch < numChannels && channel < 0; ++ch)
+		if (!std::isfinite(buffer.getSample(ch, numSamples - 1)))
+			channel = ch;
 
-	// Aca se actualizan los buffers de audio FIFO
-	leftChannelFifo.update(buffer);
-	rightChannelFifo.update(buffer);
+	const bool nonFinite = inputFinite && channel >= 0;
+
+	if (nonFinite && !nonFiniteFilterState)
+		realtimeLog.log(LogLevel::Error, "Estado no finito en el filtro del canal {}", { (double)channel });
+	else if (!nonFinite && nonFiniteFilterState && inputFinite)
+		realtimeLog.log(LogLevel::Info, "El estado de los filtros volvio a ser finito");
+
+	if (inputFinite)
+		nonFiniteFilterState = nonFinite;
+}
+
+void SimpleEQAudioProcessor::logAnalyzerDrops() {
+	// Se avisa cuando una FIFO empieza a descartar bloques y cuando se recupera, no en cada bloque
+	auto check = [this](const SingleChannelSampleFifo<BlockType>& fifo, AnalyzerDropState& state, int channel) {
+		const auto dropped = fifo.getNumDroppedBuffers();
+		const bool dropping = dropped != state.lastDropped;
+
+		if (dropping && !state.dropping)
+			realtimeLog.log(LogLevel::Warning, "Analizador: la FIFO del canal {} esta llena, se descartan bloques", { (double)channel });
+		else if (!dropping && state.dropping)
+			realtimeLog.log(LogLevel::Info, "Analizador: la FIFO del canal {} se recupero ({} bloques descartados en total)", { (double)channel, (double)dropped });
+
+		state.dropping = dropping;
+		state.lastDropped = dropped;
+	};
+
+	check(leftChannelFifo, leftAnalyzerDrops, Channel::Left);
+	check(rightChannelFifo, rightAnalyzerDrops, Channel::Right);
 }
 
 //==============================================================================
@@ -237,22 +348,59 @@ Coefficients makePeakFilter(const ChainSettings &chainSettings, double sampleRat
 
 void SimpleEQAudioProcessor::updatePeakFilter(const ChainSettings &chainSettings) {
 
-	auto peakCoefficients = makePeakFilter(chainSettings, getSampleRate()); // Version actualizada usando la funcion makePeakFilter.
+	// Coeficientes calculados en el lugar, sin alocar (antes se creaba un objeto nuevo en cada bloque)
+	auto peakCoefficients = makePeakBiquad(chainSettings, getSampleRate());
 
 	leftChain.template setBypassed<ChainPositions::Peak>(chainSettings.peakBypassed);
 	rightChain.template setBypassed<ChainPositions::Peak>(chainSettings.peakBypassed);
 
-	updateCoefficients(leftChain.get <ChainPositions::Peak>().coefficients, peakCoefficients);
-	updateCoefficients(rightChain.get <ChainPositions::Peak>().coefficients, peakCoefficients);
+	setCoefficients(leftChain.get <ChainPositions::Peak>(), peakCoefficients);
+	setCoefficients(rightChain.get <ChainPositions::Peak>(), peakCoefficients);
 }
 
 void updateCoefficients(Coefficients &old, const Coefficients &replacements) {
 	*old = *replacements;
 }
 
-void SimpleEQAudioProcessor::updateLowCutFilters(const ChainSettings &chainSettings) {
+BiquadCoefficients makePeakBiquad(const ChainSettings &chainSettings, double sampleRate) {
+	const auto gainFactor = juce::Decibels::decibelsToGain((double)chainSettings.peakGainInDecibels);
+
+	const auto A = std::sqrt(juce::jmax(0.0, gainFactor));
+	const auto omega = juce::MathConstants<double>::twoPi * juce::jmax((double)chainSettings.peakFreq, 2.0) / sampleRate;
+	const auto alpha = std::sin(omega) / (chainSettings.peakQuality * 2.0);
+	const auto c2 = -2.0 * std::cos(omega);
+	const auto alphaTimesA = alpha * A;
+	const auto alphaOverA = alpha / A;
+	const auto a0 = 1.0 + alphaOverA;
+
+	return { (1.0 + alphaTimesA) / a0, c2 / a0, (1.0 - alphaTimesA) / a0, c2 / a0, (1.0 - alphaOverA) / a0 };
+}
+
+BiquadCoefficients makeCutBiquad(float frequency, double sampleRate, int section, Slope slope, bool isHighPass) {
+	// Q de cada seccion de un Butterworth de orden par
+	const auto order = 2 * (static_cast<int>(slope) + 1);
+	const auto Q = 1.0 / (2.0 * std::cos((2.0 * section + 1.0) * juce::MathConstants<double>::pi / (order * 2.0)));
+	const auto invQ = 1.0 / Q;
+
+	const auto t = std::tan(juce::MathConstants<double>::pi * frequency / sampleRate);
+	const auto n = isHighPass ? t : 1.0 / t;
+	const auto nSquared = n * n;
+	const auto c1 = 1.0 / (1.0 + invQ * n + nSquared);
 
-	auto lowCutCoefficients = makeLowCutFilter(chainSettings, getSampleRate()); // Version actualizada usando la funcion makeLowCutFilter.
+	if (isHighPass)
+		return { c1, c1 * -2.0, c1, c1 * 2.0 * (nSquared - 1.0), c1 * (1.0 - invQ * n + nSquared) };
+
+	return { c1, c1 * 2.0, c1, c1 * 2.0 * (1.0 - nSquared), c1 * (1.0 - invQ * n + nSquared) };
+}
+
+void updateMonoChain(MonoChain& chain, const ChainSettings& chainSettings, double sampleRate) {
+	updateMonoChain(chain, chainSettings,
+		makePeakFilter(chainSettings, sampleRate),
+		makeLowCutFilter(chainSettings, sampleRate),
+		makeHighCutFilter(chainSettings, sampleRate));
+}
+
+void SimpleEQAudioProcessor::updateLowCutFilters(const ChainSettings &chainSettings) {
 
     auto& leftLowCut = leftChain.get<ChainPositions::LowCut>();
     auto& rightLowCut = rightChain.get<ChainPositions::LowCut>();
@@ -260,25 +408,29 @@ void SimpleEQAudioProcessor::updateLowCutFilters(const ChainSettings &chainSetti
 	leftChain.template setBypassed<ChainPositions::LowCut>(chainSettings.lowCutBypassed);
 	rightChain.template setBypassed<ChainPositions::LowCut>(chainSettings.lowCutBypassed);
 
-    updateCutFilter(leftLowCut, lowCutCoefficients, chainSettings.lowCutSlope);
-    updateCutFilter(rightLowCut, lowCutCoefficients, chainSettings.lowCutSlope);
+    setCutFilter(leftLowCut, chainSettings.lowCutFreq, chainSettings.lowCutSlope, true, getSampleRate());
+    setCutFilter(rightLowCut, chainSettings.lowCutFreq, chainSettings.lowCutSlope, true, getSampleRate());
 }
 
 void SimpleEQAudioProcessor::updateHighCutFilters(const ChainSettings &chainSettings) {
 
-	auto highCutCoefficients = makeHighCutFilter(chainSettings, getSampleRate()); // Version actualizada usando la funcion makeHighCutFilter.
-
     auto& leftHighCut = leftChain.get<ChainPositions::HighCut>();
     auto& rightHighCut = rightChain.get<ChainPositions::HighCut>();
 
 	leftChain.template setBypassed<ChainPositions::HighCut>(chainSettings.highCutBypassed);
 	rightChain.template setBypassed<ChainPositions::HighCut>(chainSettings.highCutBypassed);
 
-    updateCutFilter(leftHighCut, highCutCoefficients, chainSettings.highCutSlope);
-    updateCutFilter(rightHighCut, highCutCoefficients, chainSettings.highCutSlope);
+    setCutFilter(leftHighCut, chainSettings.highCutFreq, chainSettings.highCutSlope, false, getSampleRate());
+    setCutFilter(rightHighCut, chainSettings.highCutFreq, chainSettings.highCutSlope, false, getSampleRate());
 }
 
 void SimpleEQAudioProcessor::updateFilters() {
+	SIMPLEEQ_TRACE_SCOPE("updateFilters");
+
+	// setStateInformation puede llegar antes que prepareToPlay, sin sample rate no hay coeficientes que calcular
+	if (getSampleRate() <= 0.0)
+		return;
+
     auto chainSettings = getChainSettings(apvts);
 
     updateLowCutFilters(chainSettings);
@@ -286,6 +438,177 @@ void SimpleEQAudioProcessor::updateFilters() {
     updateHighCutFilters(chainSettings);
 }
 
+//==============================================================================
+// Render offline de alta calidad
+
+void SimpleEQAudioProcessor::updateRenderMode() {
+	const bool wantHighQuality = isNonRealtime();
+
+	if (settleSamplesRemaining > 0) {
+		// El host volvio al modo anterior antes de que la otra cadena terminara de asentarse: no se cambia nada
+		if (wantHighQuality == highQualityActive)
+			settleSamplesRemaining = 0;
+	}
+	else if (crossfadeSamplesRemaining == 0 && wantHighQuality != highQualityActive) {
+		// La cadena que entra arranca desde cero y se alimenta con la misma entrada durante settleLength muestras
+		// sin que se escuche; recien despues se hace el crossfade, con su estado ya igual al de la que sale
+		resetIncomingChain(wantHighQuality);
+		settleSamplesRemaining = juce::jmax(1, settleLength);
+	}
+}
+
+void SimpleEQAudioProcessor::resetIncomingChain(bool toHighQuality) {
+	auto chainSettings = getChainSettings(apvts);
+
+	if (toHighQuality) {
+		smoothedLowCutFreq.setCurrentAndTargetValue(chainSettings.lowCutFreq);
+		smoothedHighCutFreq.setCurrentAndTargetValue(chainSettings.highCutFreq);
+		smoothedPeakFreq.setCurrentAndTargetValue(chainSettings.peakFreq);
+		smoothedPeakQuality.setCurrentAndTargetValue(chainSettings.peakQuality);
+		smoothedPeakGain.setCurrentAndTargetValue(chainSettings.peakGainInDecibels);
+
+		updateHighQualityFilters(chainSettings);
+		leftChainHQ.reset();
+		rightChainHQ.reset();
+	}
+	else {
+		updateFilters();
+		leftChain.reset();
+		rightChain.reset();
+	}
+}
+
+void SimpleEQAudioProcessor::processRenderModes(juce::AudioBuffer<float>& buffer, int startSample, int numSamples, int numChannels) {
+	updateRenderMode();
+
+	const bool crossfading = crossfadeSamplesRemaining > 0;
+	const bool settling = settleSamplesRemaining > 0;
+
+	// Mientras una cadena se asienta o hay crossfade corren las dos
+	if (highQualityActive || crossfading || settling) {
+		for (int ch = 0; ch < numChannels; ++ch) {
+			auto* src = buffer.getReadPointer(ch, startSample);
+			auto* dst = highQualityBuffer.getWritePointer(ch);
+			for (int i = 0; i < numSamples; ++i)
+				dst[i] = static_cast<double>(src[i]);
+		}
+
+		processHighQuality(numSamples);
+	}
+
+	if (!highQualityActive || crossfading || settling) {
+		// Aca es donde se actualizan los coeficientes en tiempo real, para que el filtro responda a los cambios de los parametros. Se hace antes de procesar el audio.
+		updateFilters();
+
+	   // Procesamiento despues de actualizar valores
+		juce::dsp::AudioBlock<float> block(buffer);
+		block = block.getSubBlock((size_t)startSample, (size_t)numSamples);
+
+		auto leftBlock = block.getSingleChannelBlock(0);
+		auto rightBlock = block.getSingleChannelBlock(1);
+
+		juce::dsp::ProcessContextReplacing<float> leftContext(leftBlock);
+		juce::dsp::ProcessContextReplacing<float> rightContext(rightBlock);
+
+		processChainSections(leftChain, leftContext);
+		processChainSections(rightChain, rightContext);
+	}
+
+	// Lo que se escucha es la cadena activa; la que se esta asentando no sale
+	if (crossfading) {
+		mixRenderModes(buffer, startSample, numChannels, numSamples);
+	}
+	else if (highQualityActive) {
+		for (int ch = 0; ch < numChannels; ++ch) {
+			auto* src = highQualityBuffer.getReadPointer(ch);
+			auto* dst = buffer.getWritePointer(ch, startSample);
+			for (int i = 0; i < numSamples; ++i)
+				dst[i] = static_cast<float>(src[i]);
+		}
+	}
+
+	if (settling) {
+		settleSamplesRemaining -= numSamples;
+
+		if (settleSamplesRemaining <= 0) {
+			settleSamplesRemaining = 0;
+			highQualityActive = !highQualityActive;
+			crossfadeSamplesRemaining = crossfadeLength;
+		}
+	}
+}
+
+void SimpleEQAudioProcessor::updateHighQualityFilters(const ChainSettings &chainSettings) {
+	const auto sampleRate = getSampleRate();
+
+	// En el lugar y sin alocar: con automatizacion esto corre una vez por muestra
+	updateMonoChainInPlace(leftChainHQ, chainSettings, sampleRate);
+	updateMonoChainInPlace(rightChainHQ, chainSettings, sampleRate);
+}
+
+void SimpleEQAudioProcessor::processHighQuality(int numSamples) {
+	SIMPLEEQ_TRACE_SCOPE("processHighQuality");
+	auto chainSettings = getChainSettings(apvts);
+
+	smoothedLowCutFreq.setTargetValue(chainSettings.lowCutFreq);
+	smoothedHighCutFreq.setTargetValue(chainSettings.highCutFreq);
+	smoothedPeakFreq.setTargetValue(chainSettings.peakFreq);
+	smoothedPeakQuality.setTargetValue(chainSettings.peakQuality);
+	smoothedPeakGain.setTargetValue(chainSettings.peakGainInDecibels);
+
+	juce::dsp::AudioBlock<double> block(highQualityBuffer);
+	block = block.getSubBlock(0, (size_t)numSamples);
+
+	const bool smoothing = smoothedLowCutFreq.isSmoothing() || smoothedHighCutFreq.isSmoothing()
+		|| smoothedPeakFreq.isSmoothing() || smoothedPeakQuality.isSmoothing() || smoothedPeakGain.isSmoothing();
+
+	// Sin automatizacion en curso se procesa el bloque entero, igual que en tiempo real
+	const int step = smoothing ? 1 : numSamples;
+
+	for (int start = 0; start < numSamples; start += step) {
+		if (smoothing) {
+			chainSettings.lowCutFreq = smoothedLowCutFreq.getNextValue();
+			chainSettings.highCutFreq = smoothedHighCutFreq.getNextValue();
+			chainSettings.peakFreq = smoothedPeakFreq.getNextValue();
+			chainSettings.peakQuality = smoothedPeakQuality.getNextValue();
+			chainSettings.peakGainInDecibels = smoothedPeakGain.getNextValue();
+		}
+
+		updateHighQualityFilters(chainSettings);
+
+		auto subBlock = block.getSubBlock((size_t)start, (size_t)step);
+		auto leftBlock = subBlock.getSingleChannelBlock(0);
+		auto rightBlock = subBlock.getSingleChannelBlock(1);
+
+		juce::dsp::ProcessContextReplacing<double> leftContext(leftBlock);
+		juce::dsp::ProcessContextReplacing<double> rightContext(rightBlock);
+
+		leftChainHQ.process(leftContext);
+		rightChainHQ.process(rightContext);
+	}
+}
+
+void SimpleEQAudioProcessor::mixRenderModes(juce::AudioBuffer<float>& buffer, int startSample, int numChannels, int numSamples) {
+	// En buffer esta la salida de la cadena en tiempo real y en highQualityBuffer la de alta calidad
+	const auto position = crossfadeLength - crossfadeSamplesRemaining;
+
+	for (int ch = 0; ch < numChannels; ++ch) {
+		auto* live = buffer.getWritePointer(ch, startSample);
+		auto* hq = highQualityBuffer.getReadPointer(ch);
+
+		for (int i = 0; i < numSamples; ++i) {
+			// Ganancia de la cadena que entra, de 0 a 1
+			auto gain = juce::jmin(1.0, double(position + i + 1) / double(crossfadeLength));
+			if (!highQualityActive)
+				gain = 1.0 - gain;
+
+			live[i] = static_cast<float>(live[i] * (1.0 - gain) + hq[i] * gain);
+		}
+	}
+
+	crossfadeSamplesRemaining = juce::jmax(0, crossfadeSamplesRemaining - numSamples);
+}
+
 juce::AudioProcessorValueTreeState::ParameterLayout SimpleEQAudioProcessor::createParameterLayout() {
 	juce::AudioProcessorValueTreeState::ParameterLayout layout;
     
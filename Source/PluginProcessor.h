@@ -10,6 +10,9 @@
 
 #include <JuceHeader.h>
 #include "Analizador.h"
+#include "CargaDSP.h"
+#include "Trazas.h"
+#include "RegistroTiempoReal.h"
 
 enum Slope {
     Slope_12,
@@ -42,6 +45,11 @@ void updateCoefficients(Coefficients& old, const Coefficients& replacements);
 
 Coefficients makePeakFilter(const ChainSettings&, double sampleRate);
 
+// Cadena de alta calidad para renders offline (isNonRealtime): misma topologia pero en doble precision.
+using FilterHQ = juce::dsp::IIR::Filter<double>;
+using CutFilterHQ = juce::dsp::ProcessorChain<FilterHQ, FilterHQ, FilterHQ, FilterHQ>;
+using MonoChainHQ = juce::dsp::ProcessorChain<CutFilterHQ, FilterHQ, CutFilterHQ>;
+
 template<int Index, typename ChainType, typename CoefficientType>
 void update(ChainType& chain, const CoefficientType& coefficients) {
 
@@ -90,6 +98,114 @@ inline auto makeLowCutFilter(const ChainSettings& chainSettings, double sampleRa
 inline auto makeHighCutFilter(const ChainSettings& chainSettings, double sampleRate) {
     return juce::dsp::FilterDesign<float>::designIIRLowpassHighOrderButterworthMethod(chainSettings.highCutFreq, sampleRate, 2 * (chainSettings.highCutSlope + 1));
 }
+
+// Actualiza una cadena completa (bypass + coeficientes) con los coeficientes ya diseniados.
+template<typename ChainType, typename PeakCoefficientType, typename CutCoefficientType>
+void updateMonoChain(ChainType& chain, const ChainSettings& chainSettings,
+                     const PeakCoefficientType& peakCoefficients,
+                     const CutCoefficientType& lowCutCoefficients,
+                     const CutCoefficientType& highCutCoefficients) {
+
+    chain.template setBypassed<ChainPositions::LowCut>(chainSettings.lowCutBypassed);
+    chain.template setBypassed<ChainPositions::Peak>(chainSettings.peakBypassed);
+    chain.template setBypassed<ChainPositions::HighCut>(chainSettings.highCutBypassed);
+
+    updateCoefficients(chain.template get<ChainPositions::Peak>().coefficients, peakCoefficients);
+    updateCutFilter(chain.template get<ChainPositions::LowCut>(), lowCutCoefficients, chainSettings.lowCutSlope);
+    updateCutFilter(chain.template get<ChainPositions::HighCut>(), highCutCoefficients, chainSettings.highCutSlope);
+}
+
+// Version para MonoChain que disenia los coeficientes a partir de los parametros (editor y render offline)
+void updateMonoChain(MonoChain& chain, const ChainSettings& chainSettings, double sampleRate);
+
+//==============================================================================
+// Coeficientes calculados en el lugar, sin alocar, para usar en el hilo de audio.
+// Son las mismas formulas de juce::dsp::IIR::Coefficients (makePeakFilter, makeLowPass, makeHighPass)
+// y de FilterDesign::designIIR...HighOrderButterworthMethod para ordenes pares, que es lo unico que usamos.
+
+struct BiquadCoefficients {
+    double b0, b1, b2, a1, a2;  // Ya normalizados por a0
+};
+
+BiquadCoefficients makePeakBiquad(const ChainSettings& chainSettings, double sampleRate);
+BiquadCoefficients makeCutBiquad(float frequency, double sampleRate, int section, Slope slope, bool isHighPass);
+
+// El filtro tiene que tener lugar para un biquad (ver prepareCoefficientStorage)
+template<typename SampleType>
+void setCoefficients(juce::dsp::IIR::Filter<SampleType>& filter, const BiquadCoefficients& c) {
+    jassert(filter.coefficients->getFilterOrder() == 2);
+
+    auto* raw = filter.coefficients->getRawCoefficients();
+    raw[0] = static_cast<SampleType>(c.b0);
+    raw[1] = static_cast<SampleType>(c.b1);
+    raw[2] = static_cast<SampleType>(c.b2);
+    raw[3] = static_cast<SampleType>(c.a1);
+    raw[4] = static_cast<SampleType>(c.a2);
+}
+
+template<int Index, typename CutChainType>
+void setCutSection(CutChainType& cut, float frequency, Slope slope, bool isHighPass, double sampleRate) {
+    // Igual que updateCutFilter: con Slope_12 solo la seccion 0, con Slope_48 las cuatro
+    const bool active = Index <= static_cast<int>(slope);
+    cut.template setBypassed<Index>(!active);
+
+    if (active)
+        setCoefficients(cut.template get<Index>(), makeCutBiquad(frequency, sampleRate, Index, slope, isHighPass));
+}
+
+template<typename CutChainType>
+void setCutFilter(CutChainType& cut, float frequency, Slope slope, bool isHighPass, double sampleRate) {
+    setCutSection<0>(cut, frequency, slope, isHighPass, sampleRate);
+    setCutSection<1>(cut, frequency, slope, isHighPass, sampleRate);
+    setCutSection<2>(cut, frequency, slope, isHighPass, sampleRate);
+    setCutSection<3>(cut, frequency, slope, isHighPass, sampleRate);
+}
+
+template<typename ChainType>
+void updateMonoChainInPlace(ChainType& chain, const ChainSettings& chainSettings, double sampleRate) {
+    chain.template setBypassed<ChainPositions::LowCut>(chainSettings.lowCutBypassed);
+    chain.template setBypassed<ChainPositions::Peak>(chainSettings.peakBypassed);
+    chain.template setBypassed<ChainPositions::HighCut>(chainSettings.highCutBypassed);
+
+    setCoefficients(chain.template get<ChainPositions::Peak>(), makePeakBiquad(chainSettings, sampleRate));
+    setCutFilter(chain.template get<ChainPositions::LowCut>(), chainSettings.lowCutFreq, chainSettings.lowCutSlope, true, sampleRate);
+    setCutFilter(chain.template get<ChainPositions::HighCut>(), chainSettings.highCutFreq, chainSettings.highCutSlope, false, sampleRate);
+}
+
+// Deja cada filtro de la cadena con lugar para un biquad. Fuera del hilo de audio (constructor del processor).
+template<typename SampleType>
+void prepareBiquadStorage(juce::dsp::IIR::Filter<SampleType>& filter) {
+    *filter.coefficients = juce::dsp::IIR::Coefficients<SampleType>(1, 0, 0, 1, 0, 0);
+}
+
+template<typename ChainType>
+void prepareCoefficientStorage(ChainType& chain) {
+    auto prepareCut = [](auto& cut) {
+        prepareBiquadStorage(cut.template get<0>());
+        prepareBiquadStorage(cut.template get<1>());
+        prepareBiquadStorage(cut.template get<2>());
+        prepareBiquadStorage(cut.template get<3>());
+    };
+
+    prepareCut(chain.template get<ChainPositions::LowCut>());
+    prepareBiquadStorage(chain.template get<ChainPositions::Peak>());
+    prepareCut(chain.template get<ChainPositions::HighCut>());
+}
+
+// Igual que ProcessorChain::process, pero con un marcador de traza por seccion de la cadena
+template<typename ChainType, typename ContextType>
+void processChainSections(ChainType& chain, const ContextType& context) {
+    auto processSection = [&context](auto& section, bool bypassed, const char* name) {
+        SIMPLEEQ_TRACE_SCOPE(name);
+        auto sectionContext = context;
+        sectionContext.isBypassed = bypassed || context.isBypassed;
+        section.process(sectionContext);
+    };
+
+    processSection(chain.template get<ChainPositions::LowCut>(), chain.template isBypassed<ChainPositions::LowCut>(), "LowCut");
+    processSection(chain.template get<ChainPositions::Peak>(), chain.template isBypassed<ChainPositions::Peak>(), "Peak");
+    processSection(chain.template get<ChainPositions::HighCut>(), chain.template isBypassed<ChainPositions::HighCut>(), "HighCut");
+}
 //==============================================================================
 
 class SimpleEQAudioProcessor : public juce::AudioProcessor
@@ -141,10 +257,25 @@ public:
 	SingleChannelSampleFifo<BlockType> leftChannelFifo{ Channel::Left };
     SingleChannelSampleFifo<BlockType> rightChannelFifo{ Channel::Right };
 
+	// El analizador solo se alimenta si hay un editor abierto y "Analyzer Enabled" esta prendido.
+	// El editor avisa en su constructor y destructor; el hilo de audio solo lee dos atomics.
+	void setAnalyzerEditorOpen(bool isOpen) { analyzerEditors.fetch_add(isOpen ? 1 : -1, std::memory_order_release); }
+	bool isAnalyzerEnabled() const { return analyzerEnabledParam->load(std::memory_order_relaxed) > 0.5f; }
+	bool isAnalyzerTapActive() const { return analyzerEditors.load(std::memory_order_acquire) > 0 && isAnalyzerEnabled(); }
+
+	// Carga DSP de esta instancia, la muestra el editor sobre la curva de respuesta
+	DspLoadMeter dspLoadMeter;
+
+	// Compartido entre todas las instancias del proceso; el editor lo prende y apaga
+	juce::SharedResourcePointer<Trace::Recorder> traceRecorder;
+
 private:
 
     MonoChain leftChain, rightChain;
 
+    std::atomic<int> analyzerEditors{ 0 };
+    std::atomic<float>* analyzerEnabledParam{ apvts.getRawParameterValue("Analyzer Enabled") };
+
     // Refactoring DSP
     void updatePeakFilter(const ChainSettings& chainSettings);
     
@@ -155,6 +286,47 @@ private:
 	void updateHighCutFilters(const ChainSettings& chainSettings);
 
 	void updateFilters();
+
+    //==============================================================================
+    // Modo de render offline: cuando el host avisa isNonRealtime() se usa la cadena en doble precision
+    // con suavizado por muestra. Ambas cadenas y highQualityBuffer se preparan en prepareToPlay, asi el cambio no aloca.
+    // Al cambiar de modo la cadena que entra primero se asienta con la entrada en vivo (settleLength muestras,
+    // sin escucharse) y despues se hace un crossfade de crossfadeLength muestras.
+    MonoChainHQ leftChainHQ, rightChainHQ;
+    juce::AudioBuffer<double> highQualityBuffer;
+
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative> smoothedLowCutFreq, smoothedHighCutFreq, smoothedPeakFreq, smoothedPeakQuality;
+    juce::SmoothedValue<float> smoothedPeakGain;
+
+    bool highQualityActive{ false };
+    int crossfadeLength{ 0 }, crossfadeSamplesRemaining{ 0 };
+    int settleLength{ 0 }, settleSamplesRemaining{ 0 };
+
+    void updateRenderMode();
+    void resetIncomingChain(bool toHighQuality);
+    void processRenderModes(juce::AudioBuffer<float>& buffer, int startSample, int numSamples, int numChannels);
+    void updateHighQualityFilters(const ChainSettings& chainSettings);
+    void processHighQuality(int numSamples);
+    void mixRenderModes(juce::AudioBuffer<float>& buffer, int startSample, int numChannels, int numSamples);
+
+    //==============================================================================
+    // Diagnostico desde el hilo de audio (ver RegistroTiempoReal.h)
+    RealtimeLogger realtimeLog;
+    double loggedSampleRate{ 0.0 };
+
+    struct AnalyzerDropState
+    {
+        int lastDropped = 0;
+        bool dropping = false;
+    };
+    AnalyzerDropState leftAnalyzerDrops, rightAnalyzerDrops;
+
+    // Solo registran, no tocan el audio ni las cadenas. Se avisa al empezar y al terminar cada episodio, no en cada bloque.
+    bool nonFiniteInput{ false }, nonFiniteFilterState{ false };
+
+    bool checkInput(const juce::AudioBuffer<float>& buffer, int numChannels, int numSamples);
+    void checkFilterState(const juce::AudioBuffer<float>& buffer, int numChannels, int numSamples, bool inputFinite);
+    void logAnalyzerDrops();
     
   //==============================================================================
    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SimpleEQAudioProcessor)
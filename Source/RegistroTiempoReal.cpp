@@ -0,0 +1,178 @@
+/*
+  ==============================================================================
+
+    RegistroTiempoReal.cpp
+    Created: 22 Oct 2026 11:08:14am
+    Author:  usuario
+
+  ==============================================================================
+*/
+
+#include "RegistroTiempoReal.h"
+
+namespace
+{
+    juce::String formatValue(double value)
+    {
+        if (!std::isfinite(value))
+            return std::isnan(value) ? "nan" : (value > 0 ? "inf" : "-inf");
+
+        // Los enteros (canales, muestras, sample rates) sin decimales
+        if (value == std::floor(value) && std::abs(value) < 1.0e15)
+            return juce::String((juce::int64)value);
+
+        return juce::String(value, 4);
+    }
+
+    const char* levelName(LogLevel level)
+    {
+        switch (level)
+        {
+            case LogLevel::Warning: return "WARN ";
+            case LogLevel::Error:   return "ERROR";
+            default:                return "INFO ";
+        }
+    }
+}
+
+//==============================================================================
+RealtimeLogger::RealtimeLogger() : instanceId(writer->add(this))
+{
+}
+
+RealtimeLogger::~RealtimeLogger()
+{
+    writer->remove(this);
+}
+
+void RealtimeLogger::log(LogLevel level, const char* message, std::initializer_list<double> values) noexcept
+{
+    auto write = fifo.write(1);
+
+    if (write.blockSize1 == 0)
+    {
+        droppedRecords.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    auto& record = records[(size_t)write.startIndex1];
+    record.timeMillis = juce::Time::currentTimeMillis();
+    record.message = message;
+    record.level = level;
+    record.numValues = 0;
+
+    for (auto v : values)
+        if (record.numValues < LogRecord::maxValues)
+            record.values[(size_t)record.numValues++] = v;
+}
+
+//==============================================================================
+RealtimeLogWriter::RealtimeLogWriter()
+    : juce::Thread("SimpleEQ log writer"),
+      logFile(juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+                  .getChildFile("SimpleEQ").getChildFile("Logs").getChildFile("SimpleEQ.log"))
+{
+    startThread(juce::Thread::Priority::low);
+}
+
+RealtimeLogWriter::~RealtimeLogWriter()
+{
+    stopThread(1000);
+}
+
+int RealtimeLogWriter::add(RealtimeLogger* logger)
+{
+    const juce::ScopedLock sl(lock);
+    loggers.add(logger);
+    return nextInstanceId++;
+}
+
+void RealtimeLogWriter::remove(RealtimeLogger* logger)
+{
+    // Lo ultimo que haya quedado en la cola se escribe antes de que el logger desaparezca
+    const juce::ScopedLock sl(lock);
+    drain(*logger);
+    loggers.removeFirstMatchingValue(logger);
+}
+
+void RealtimeLogWriter::run()
+{
+    while (!threadShouldExit())
+    {
+        {
+            const juce::ScopedLock sl(lock);
+            for (auto* logger : loggers)
+                drain(*logger);
+        }
+
+        wait(100);
+    }
+}
+
+void RealtimeLogWriter::drain(RealtimeLogger& logger)
+{
+    const auto prefix = " SimpleEQ#" + juce::String(logger.instanceId) + " ";
+
+    for (auto numReady = logger.fifo.getNumReady(); numReady > 0; --numReady)
+    {
+        auto read = logger.fifo.read(1);
+        if (read.blockSize1 == 0)
+            break;
+
+        const auto& record = logger.records[(size_t)read.startIndex1];
+
+        juce::String text(record.message);
+        for (int i = 0; i < record.numValues; ++i)
+            text = text.replaceFirstOccurrenceOf("{}", formatValue(record.values[(size_t)i]));
+
+        writeLine(juce::Time(record.timeMillis).toISO8601(true) + prefix + levelName(record.level) + " " + text);
+    }
+
+    const auto dropped = logger.droppedRecords.load(std::memory_order_relaxed);
+    if (dropped > logger.reportedDroppedRecords)
+    {
+        writeLine(juce::Time::getCurrentTime().toISO8601(true) + prefix + levelName(LogLevel::Warning) + " "
+                  + juce::String(dropped - logger.reportedDroppedRecords) + " registros descartados (cola llena)");
+        logger.reportedDroppedRecords = dropped;
+    }
+
+    if (stream != nullptr)
+        stream->flush();
+}
+
+void RealtimeLogWriter::writeLine(const juce::String& line)
+{
+    if (stream == nullptr)
+    {
+        logFile.getParentDirectory().createDirectory();
+        stream = std::make_unique<juce::FileOutputStream>(logFile);
+
+        if (!stream->openedOk())
+        {
+            stream.reset();
+            return;
+        }
+    }
+
+    *stream << line << juce::newLine;
+
+    if (stream->getPosition() > maxFileSize)
+        rotate();
+}
+
+void RealtimeLogWriter::rotate()
+{
+    stream.reset();
+
+    // SimpleEQ.log -> SimpleEQ.1.log -> SimpleEQ.2.log ... y el mas viejo se borra
+    auto oldFile = [this](int index) {
+        return logFile.getSiblingFile(logFile.getFileNameWithoutExtension() + "." + juce::String(index) + logFile.getFileExtension());
+    };
+
+    oldFile(numOldFiles).deleteFile();
+
+    for (int i = numOldFiles - 1; i >= 1; --i)
+        oldFile(i).moveFileTo(oldFile(i + 1));
+
+    logFile.moveFileTo(oldFile(1));
+}
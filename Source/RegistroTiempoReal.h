@@ -0,0 +1,99 @@
+/*
+  ==============================================================================
+
+    RegistroTiempoReal.h
+    Created: 22 Oct 2026 11:08:14am
+    Author:  usuario
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+
+// Canal de log que se puede usar desde processBlock (juce::Logger aloca y toma locks):
+// 1. Cada processor tiene su RealtimeLogger: una cola de registros de tamano fijo sobre un juce::AbstractFifo.
+//    log() no aloca ni bloquea; si la cola esta llena descarta el registro y lo cuenta.
+// 2. Los registros guardan un literal y hasta 4 valores. Cada "{}" del literal se reemplaza por el valor siguiente.
+// 3. Un RealtimeLogWriter compartido (SharedResourcePointer) vacia las colas cada 100 ms y les da formato.
+//    Escribe en SimpleEQ.log y rota el archivo al pasar de 1 MB, guardando los 3 anteriores.
+// Solo el hilo de audio de cada instancia llama a log(): la cola es de un productor y un consumidor.
+
+enum class LogLevel
+{
+    Info,
+    Warning,
+    Error
+};
+
+struct LogRecord
+{
+    static constexpr int maxValues = 4;
+
+    juce::int64 timeMillis;
+    const char* message;
+    std::array<double, maxValues> values;
+    int numValues;
+    LogLevel level;
+};
+
+class RealtimeLogger;
+
+class RealtimeLogWriter : private juce::Thread
+{
+public:
+    RealtimeLogWriter();
+    ~RealtimeLogWriter() override;
+
+    // Devuelve el numero de instancia que aparece en cada linea del log
+    int add(RealtimeLogger* logger);
+    void remove(RealtimeLogger* logger);
+
+    juce::File getLogFile() const { return logFile; }
+
+private:
+    static constexpr juce::int64 maxFileSize = 1 << 20;
+    static constexpr int numOldFiles = 3;
+
+    juce::CriticalSection lock;
+    juce::Array<RealtimeLogger*> loggers;
+    int nextInstanceId = 1;
+
+    const juce::File logFile;
+    std::unique_ptr<juce::FileOutputStream> stream;
+
+    void run() override;
+    void drain(RealtimeLogger& logger);
+    void writeLine(const juce::String& line);
+    void rotate();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RealtimeLogWriter)
+};
+
+class RealtimeLogger
+{
+public:
+    RealtimeLogger();
+    ~RealtimeLogger();
+
+    void log(LogLevel level, const char* message, std::initializer_list<double> values = {}) noexcept;
+
+    juce::int64 getNumDroppedRecords() const noexcept { return droppedRecords.load(std::memory_order_relaxed); }
+
+private:
+    friend class RealtimeLogWriter;
+
+    static constexpr int capacity = 256;
+    std::array<LogRecord, capacity> records;
+    juce::AbstractFifo fifo{ capacity };
+
+    std::atomic<juce::int64> droppedRecords{ 0 };
+    juce::int64 reportedDroppedRecords = 0;     // solo el writer
+
+    juce::SharedResourcePointer<RealtimeLogWriter> writer;
+    const int instanceId;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RealtimeLogger)
+};
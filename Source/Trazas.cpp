@@ -0,0 +1,232 @@
+/*
+  ==============================================================================
+
+    Trazas.cpp
+    Created: 21 Oct 2026 6:25:51pm
+    Author:  usuario
+
+  ==============================================================================
+*/
+
+#include "Trazas.h"
+
+namespace Trace
+{
+    std::atomic<Recorder*> Recorder::instance{ nullptr };
+
+    namespace
+    {
+        // Cada hilo recuerda su ring buffer; la generacion evita usar el de un Recorder ya destruido
+        std::atomic<int> nextGeneration{ 0 };
+        thread_local int cachedGeneration = -1;
+        thread_local int cachedIndex = -1;
+        thread_local const char* currentThreadName = nullptr;
+    }
+
+    Recorder::Recorder() : juce::Thread("SimpleEQ trace writer"), generation(++nextGeneration)
+    {
+        instance.store(this, std::memory_order_release);
+    }
+
+    Recorder::~Recorder()
+    {
+        stop();
+
+        auto* expected = this;
+        instance.compare_exchange_strong(expected, nullptr);
+    }
+
+    bool Recorder::start(const juce::File& file, int maxThreads)
+    {
+        if (isRecording())
+            return true;
+
+        // Los ring buffers se alocan una sola vez y quedan vivos hasta destruir el Recorder.
+        // Una grabacion con mas hilos que la anterior agrega los que faltan.
+        const auto numBuffers = juce::jlimit(1, maxThreadSlots, maxThreads);
+
+        for (auto i = (int)ownedBuffers.size(); i < numBuffers; ++i)
+        {
+            ownedBuffers.push_back(std::make_unique<ThreadBuffer>());
+            threads[(size_t)i].store(ownedBuffers.back().get(), std::memory_order_release);
+        }
+
+        file.getParentDirectory().createDirectory();
+        stream = std::make_unique<juce::FileOutputStream>(file);
+
+        if (!stream->openedOk())
+        {
+            stream.reset();
+            return false;
+        }
+
+        stream->setPosition(0);
+        stream->truncate();
+        *stream << "[\n";
+        firstEvent = true;
+
+        // Lo que quedo de una grabacion anterior no se escribe
+        for (auto& buffer : ownedBuffers)
+        {
+            buffer->readIndex.store(buffer->writeIndex.load(std::memory_order_acquire), std::memory_order_release);
+            buffer->writtenName = nullptr;
+        }
+
+        startTicks = juce::Time::getHighResolutionTicks();
+        ticksToMicroseconds = 1.0e6 / (double)juce::Time::getHighResolutionTicksPerSecond();
+        droppedEvents = 0;
+
+        enabled.store(true, std::memory_order_release);
+        startThread();
+        return true;
+    }
+
+    void Recorder::stop()
+    {
+        if (!isRecording())
+            return;
+
+        enabled.store(false, std::memory_order_release);
+        stopThread(1000);
+
+        drain();
+
+        // Lo que se perdio queda en la traza misma, no solo en getNumDroppedEvents()
+        writeEvent("{\"name\":\"trace_stats\",\"ph\":\"M\",\"pid\":1,\"args\":{\"droppedEvents\":"
+                   + juce::String(getNumDroppedEvents()) + ",\"unregisteredThreads\":" + juce::String(getNumUnregisteredThreads())
+                   + ",\"threadBuffers\":" + juce::String(getNumBufferedThreads()) + "}}");
+
+        // El formato de Chrome acepta el array sin cerrar, pero asi el archivo tambien es JSON valido
+        *stream << "\n]\n";
+        stream->flush();
+        stream.reset();
+    }
+
+    void Recorder::nameCurrentThread(const char* name) noexcept
+    {
+        currentThreadName = name;
+
+        auto* recorder = instance.load(std::memory_order_acquire);
+        if (recorder == nullptr || !recorder->isRecording())
+            return;
+
+        if (auto* buffer = recorder->getBufferForCurrentThread(name))
+            buffer->name.store(name, std::memory_order_release);
+    }
+
+    void Recorder::record(const char* name, char phase, double value) noexcept
+    {
+        auto* recorder = instance.load(std::memory_order_acquire);
+        if (recorder == nullptr || !recorder->isRecording())
+            return;
+
+        auto* buffer = recorder->getBufferForCurrentThread(name);
+        if (buffer == nullptr)
+        {
+            recorder->droppedEvents.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        const auto write = buffer->writeIndex.load(std::memory_order_relaxed);
+        if (write - buffer->readIndex.load(std::memory_order_acquire) >= eventsPerThread)
+        {
+            recorder->droppedEvents.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        buffer->events[write & (eventsPerThread - 1)] = { name, juce::Time::getHighResolutionTicks(), value, phase };
+        buffer->writeIndex.store(write + 1, std::memory_order_release);
+    }
+
+    Recorder::ThreadBuffer* Recorder::getBufferForCurrentThread(const char* firstEventName) noexcept
+    {
+        if (cachedGeneration != generation)
+        {
+            const auto index = numThreads.fetch_add(1, std::memory_order_relaxed);
+
+            cachedGeneration = generation;
+            cachedIndex = index < maxThreadSlots ? index : -1;
+
+            // Primer evento del hilo en esta traza: se le pone nombre una sola vez
+            if (auto* buffer = cachedIndex >= 0 ? threads[(size_t)cachedIndex].load(std::memory_order_acquire) : nullptr)
+            {
+                const char* name = currentThreadName;
+                if (name == nullptr)
+                    name = juce::MessageManager::existsAndIsCurrentThread() ? "Message" : firstEventName;
+
+                buffer->name.store(name, std::memory_order_release);
+            }
+        }
+
+        // nullptr si el hilo no entra en los buffers alocados: el evento se descarta y el hilo cuenta como no registrado
+        return cachedIndex >= 0 ? threads[(size_t)cachedIndex].load(std::memory_order_acquire) : nullptr;
+    }
+
+    int Recorder::getNumBufferedThreads() const noexcept
+    {
+        return juce::jmin(numThreads.load(std::memory_order_relaxed), (int)ownedBuffers.size());
+    }
+
+    int Recorder::getNumUnregisteredThreads() const noexcept
+    {
+        return juce::jmax(0, numThreads.load(std::memory_order_relaxed) - (int)ownedBuffers.size());
+    }
+
+    void Recorder::run()
+    {
+        while (!threadShouldExit())
+        {
+            drain();
+            wait(20);
+        }
+    }
+
+    void Recorder::drain()
+    {
+        const auto numActive = getNumBufferedThreads();
+
+        for (int tid = 0; tid < numActive; ++tid)
+        {
+            auto& buffer = *ownedBuffers[(size_t)tid];
+
+            if (auto* name = buffer.name.load(std::memory_order_acquire); name != nullptr && name != buffer.writtenName)
+            {
+                writeEvent("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + juce::String(tid)
+                           + ",\"args\":{\"name\":\"" + juce::String(name) + "\"}}");
+                buffer.writtenName = name;
+            }
+
+            const auto write = buffer.writeIndex.load(std::memory_order_acquire);
+            auto read = buffer.readIndex.load(std::memory_order_relaxed);
+
+            for (; read != write; ++read)
+            {
+                const auto& e = buffer.events[read & (eventsPerThread - 1)];
+                const auto ts = (double)(e.ticks - startTicks) * ticksToMicroseconds;
+
+                juce::String json;
+                json << "{\"name\":\"" << e.name << "\",\"ph\":\"" << juce::String::charToString(e.phase)
+                     << "\",\"ts\":" << juce::String(ts, 3) << ",\"pid\":1,\"tid\":" << tid;
+
+                if (e.phase == 'C')
+                    json << ",\"args\":{\"value\":" << juce::String(e.value, 3) << "}";
+
+                json << "}";
+                writeEvent(json);
+            }
+
+            buffer.readIndex.store(read, std::memory_order_release);
+        }
+
+        stream->flush();
+    }
+
+    void Recorder::writeEvent(const juce::String& json)
+    {
+        if (!firstEvent)
+            *stream << ",\n";
+
+        *stream << json;
+        firstEvent = false;
+    }
+}
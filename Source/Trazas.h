@@ -0,0 +1,111 @@
+/*
+  ==============================================================================
+
+    Trazas.h
+    Created: 21 Oct 2026 6:25:51pm
+    Author:  usuario
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <vector>
+
+// Grabador de trazas para ver en chrome://tracing o en Perfetto:
+// 1. Cada hilo escribe eventos begin/end/counter en su propio ring buffer (un productor, un consumidor, sin locks).
+// 2. Los ring buffers se alocan todos juntos en start(), desde el message thread; el hilo de audio solo toma uno libre.
+// 3. Un hilo de fondo los vacia cada 20 ms al archivo JSON. Si un ring se llena, el evento se descarta y se cuenta.
+// Mientras no se esta grabando, cada marcador cuesta solo la lectura de un atomic.
+// Los nombres de los eventos tienen que ser literales: se guarda el puntero, no el texto.
+// El nombre de cada hilo se fija una vez, al registrarse en la traza: el de nameCurrentThread() si el hilo lo llamo
+// alguna vez (aunque sea antes de start()), "Message" en el message thread, o si no el nombre de su primer evento.
+// start() aloca ring buffers para maxThreads hilos (por defecto defaultMaxThreads, hasta maxThreadSlots).
+// Los eventos de hilos de mas se descartan; al cerrar la traza se escriben en la metadata cuantos eventos
+// se descartaron y cuantos hilos quedaron sin ring buffer.
+
+namespace Trace
+{
+    struct Event
+    {
+        const char* name;
+        juce::int64 ticks;
+        double value;
+        char phase;     // 'B', 'E' o 'C', como en el formato de Chrome
+    };
+
+    class Recorder : private juce::Thread
+    {
+    public:
+        Recorder();
+        ~Recorder() override;
+
+        static constexpr int defaultMaxThreads = 64;
+        static constexpr int maxThreadSlots = 256;
+
+        // Solo desde el message thread
+        bool start(const juce::File& file, int maxThreads = defaultMaxThreads);
+        void stop();
+
+        bool isRecording() const noexcept { return enabled.load(std::memory_order_acquire); }
+        juce::int64 getNumDroppedEvents() const noexcept { return droppedEvents.load(std::memory_order_relaxed); }
+
+        // Hilos que escribieron algun evento pero no tienen ring buffer (mas que maxThreads)
+        int getNumUnregisteredThreads() const noexcept;
+
+        // Desde cualquier hilo
+        static void begin(const char* name) noexcept { record(name, 'B', 0.0); }
+        static void end(const char* name) noexcept { record(name, 'E', 0.0); }
+        static void counter(const char* name, double value) noexcept { record(name, 'C', value); }
+        // Una vez por hilo, al arrancar: vale para esta traza y las siguientes
+        static void nameCurrentThread(const char* name) noexcept;
+
+    private:
+        static constexpr juce::uint32 eventsPerThread = 1 << 13;
+
+        struct ThreadBuffer
+        {
+            std::array<Event, eventsPerThread> events;
+            std::atomic<juce::uint32> writeIndex{ 0 }, readIndex{ 0 };
+            std::atomic<const char*> name{ nullptr };
+            const char* writtenName = nullptr;  // solo el hilo escritor
+        };
+
+        // Los hilos leen los punteros sin lock; los buffers son de ownedBuffers y viven hasta destruir el Recorder
+        std::array<std::atomic<ThreadBuffer*>, maxThreadSlots> threads{};
+        std::vector<std::unique_ptr<ThreadBuffer>> ownedBuffers;
+        std::atomic<int> numThreads{ 0 };
+        std::atomic<bool> enabled{ false };
+        std::atomic<juce::int64> droppedEvents{ 0 };
+        const int generation;
+
+        std::unique_ptr<juce::FileOutputStream> stream;
+        juce::int64 startTicks = 0;
+        double ticksToMicroseconds = 0.0;
+        bool firstEvent = true;
+
+        static std::atomic<Recorder*> instance;
+
+        static void record(const char* name, char phase, double value) noexcept;
+        ThreadBuffer* getBufferForCurrentThread(const char* firstEventName) noexcept;
+        int getNumBufferedThreads() const noexcept;
+
+        void run() override;
+        void drain();
+        void writeEvent(const juce::String& json);
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Recorder)
+    };
+
+    struct ScopedEvent
+    {
+        explicit ScopedEvent(const char* n) noexcept : name(n) { Recorder::begin(name); }
+        ~ScopedEvent() noexcept { Recorder::end(name); }
+
+        const char* name;
+    };
+}
+
+#define SIMPLEEQ_TRACE_SCOPE(name) Trace::ScopedEvent JUCE_JOIN_MACRO(traceScope, __LINE__)(name)
@@ -0,0 +1,67 @@
+/*
+  ==============================================================================
+
+    AllocationCounter.cpp
+    Created: 20 Oct 2026 9:21:17am
+    Author:  usuario
+
+  ==============================================================================
+*/
+
+#include "AllocationCounter.h"
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+    thread_local bool counting = false;
+    thread_local juce::int64 numAllocations = 0;
+}
+
+void AllocationCounter::start()
+{
+    numAllocations = 0;
+    counting = true;
+}
+
+juce::int64 AllocationCounter::stop()
+{
+    counting = false;
+    return numAllocations;
+}
+
+void AllocationCounter::noteAllocation() noexcept
+{
+    if (counting)
+        ++numAllocations;
+}
+
+//==============================================================================
+// Los reemplazos de los operadores globales son parte de la instrumentacion: solo en la configuracion RealtimeChecks
+#if SIMPLEEQ_REALTIME_CHECKS
+namespace
+{
+    void* allocate(std::size_t size)
+    {
+        RealtimeCheck::check("operator new");
+
+        // En Linux std::malloc ya cuenta (RealtimeChecks.cpp); aca se contaria dos veces
+       #if !JUCE_LINUX
+        AllocationCounter::noteAllocation();
+       #endif
+
+        if (auto* p = std::malloc(size == 0 ? 1 : size))
+            return p;
+
+        throw std::bad_alloc();
+    }
+}
+
+void* operator new(std::size_t size) { return allocate(size); }
+void* operator new[](std::size_t size) { return allocate(size); }
+// En Linux free() ya pasa por el chequeo de tiempo real
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+#endif
@@ -0,0 +1,28 @@
+/*
+  ==============================================================================
+
+    AllocationCounter.h
+    Created: 20 Oct 2026 9:21:17am
+    Author:  usuario
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "../../../Source/ChequeoTiempoReal.h"
+
+// Cuenta las allocations hechas por el hilo actual entre start() y stop(), solo en la configuracion RealtimeChecks
+// (SIMPLEEQ_REALTIME_CHECKS=1). En Debug y Release no se reemplaza nada y stop() siempre devuelve 0.
+// En Linux cuentan los hooks de malloc/calloc/realloc de RealtimeChecks.cpp, asi que entra todo lo que pasa por
+// HeapBlock (Array, AudioBuffer, coeficientes) y no solo operator new. En las demas plataformas solo operator new.
+namespace AllocationCounter
+{
+    constexpr bool isAvailable = SIMPLEEQ_REALTIME_CHECKS != 0;
+
+    // Desde los reemplazos de malloc y operator new
+    void noteAllocation() noexcept;
+
+    void start();
+    juce::int64 stop();
+}
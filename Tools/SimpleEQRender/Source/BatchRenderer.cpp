@@ -0,0 +1,226 @@
+/*
+  ==============================================================================
+
+    BatchRenderer.cpp
+    Created: 18 Oct 2026 10:12:40am
+    Author:  usuario
+
+  ==============================================================================
+*/
+
+#include "BatchRenderer.h"
+#include "../../../Source/PluginProcessor.h"
+#include <map>
+
+BatchRenderer::BatchRenderer(RenderSettings settingsToUse) : settings(std::move(settingsToUse))
+{
+}
+
+juce::Result BatchRenderer::loadStateFromBlob(const juce::File& file, juce::MemoryBlock& state)
+{
+    if (!file.loadFileAsData(state) || state.isEmpty())
+        return juce::Result::fail("No se pudo leer el estado: " + file.getFullPathName());
+
+    // Comprobamos que el blob sea un estado valido antes de lanzar cientos de trabajos
+    if (!juce::ValueTree::readFromData(state.getData(), state.getSize()).isValid())
+        return juce::Result::fail("El archivo no contiene un estado de SimpleEQ: " + file.getFullPathName());
+
+    return juce::Result::ok();
+}
+
+juce::Result BatchRenderer::loadStateFromSettingsJson(const juce::File& file, juce::MemoryBlock& state)
+{
+    auto parsed = juce::JSON::parse(file);
+    if (!parsed.isObject())
+        return juce::Result::fail("JSON invalido: " + file.getFullPathName());
+
+    // Claves del JSON (nombres de ChainSettings) -> IDs de los parametros del APVTS
+    static const std::array<std::pair<const char*, const char*>, 10> keys{ {
+        { "lowCutFreq", "LowCut Freq" },
+        { "highCutFreq", "HighCut Freq" },
+        { "peakFreq", "Peak Freq" },
+        { "peakGainInDecibels", "Peak Gain" },
+        { "peakQuality", "Peak Q" },
+        { "lowCutSlope", "LowCut Slope" },
+        { "highCutSlope", "HighCut Slope" },
+        { "lowCutBypassed", "LowCut Bypass" },
+        { "peakBypassed", "Peak Bypass" },
+        { "highCutBypassed", "HighCut Bypass" },
+    } };
+
+    SimpleEQAudioProcessor processor;
+
+    for (const auto& [key, paramID] : keys)
+    {
+        if (!parsed.hasProperty(key))
+            continue;
+
+        auto* param = processor.apvts.getParameter(paramID);
+        jassert(param != nullptr);
+        param->setValueNotifyingHost(param->convertTo0to1(static_cast<float>(parsed[key])));
+    }
+
+    // copyState() vuelca los valores de los parametros al ValueTree antes de serializarlo
+    state.reset();
+    juce::MemoryOutputStream mos(state, false);
+    processor.apvts.copyState().writeToStream(mos);
+
+    return juce::Result::ok();
+}
+
+juce::File BatchRenderer::getOutputFileFor(const juce::File& input) const
+{
+    return settings.outputDirectory.getChildFile(input.getFileName());
+}
+
+juce::Result BatchRenderer::renderFile(const juce::File& input, const juce::File& output) const
+{
+    if (input == output)
+        return juce::Result::fail("La salida pisaria la entrada: " + input.getFullPathName());
+
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+
+    std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(input));
+    if (reader == nullptr)
+        return juce::Result::fail("No se pudo abrir: " + input.getFullPathName());
+
+    // El processor solo maneja mono (duplicado a estereo) o estereo
+    if (reader->numChannels < 1 || reader->numChannels > 2)
+        return juce::Result::fail("Solo se admiten archivos mono o estereo: " + input.getFullPathName());
+
+    auto* format = formatManager.findFormatForFileExtension(output.getFileExtension());
+    if (format == nullptr)
+        return juce::Result::fail("Formato de salida desconocido: " + output.getFullPathName());
+
+    output.deleteFile();
+    std::unique_ptr<juce::FileOutputStream> stream(output.createOutputStream());
+    if (stream == nullptr || stream->failedToOpen())
+        return juce::Result::fail("No se pudo crear: " + output.getFullPathName());
+
+    std::unique_ptr<juce::AudioFormatWriter> writer(format->createWriterFor(stream.get(),
+        reader->sampleRate,
+        reader->numChannels,
+        (int)reader->bitsPerSample,
+        reader->metadataValues,
+        0));
+
+    if (writer == nullptr)
+        return juce::Result::fail("El formato no acepta esta configuracion: " + output.getFullPathName());
+
+    // Desde aca el writer es el duenio del stream
+    stream.release();
+
+    SimpleEQAudioProcessor processor;
+    prepareOfflineProcessor(processor, settings, reader->sampleRate);
+
+    juce::AudioBuffer<float> buffer(2, settings.blockSize);
+
+    for (juce::int64 position = 0; position < reader->lengthInSamples; position += settings.blockSize)
+    {
+        const auto numSamples = (int)juce::jmin<juce::int64>(settings.blockSize, reader->lengthInSamples - position);
+
+        // Con un archivo mono, read() duplica el canal en el segundo canal del buffer
+        reader->read(&buffer, 0, numSamples, position, true, true);
+        processInBlocks(processor, buffer, numSamples, settings.blockSize);
+
+        if (!writer->writeFromAudioSampleBuffer(buffer, 0, numSamples))
+        {
+            processor.releaseResources();
+            return juce::Result::fail("Error de escritura: " + output.getFullPathName());
+        }
+    }
+
+    processor.releaseResources();
+    return juce::Result::ok();
+}
+
+void BatchRenderer::prepareOfflineProcessor(SimpleEQAudioProcessor& processor, const RenderSettings& settings, double sampleRate)
+{
+    // Igual que un host: primero sample rate y estado, despues prepareToPlay.
+    // Render offline: el processor usa su cadena de alta calidad
+    processor.setNonRealtime(true);
+    processor.setRateAndBufferSizeDetails(sampleRate, settings.blockSize);
+    processor.setStateInformation(settings.state.getData(), (int)settings.state.getSize());
+    processor.prepareToPlay(sampleRate, settings.blockSize);
+}
+
+void BatchRenderer::processInBlocks(SimpleEQAudioProcessor& processor, juce::AudioBuffer<float>& buffer, int numSamples, int blockSize)
+{
+    juce::MidiBuffer midi;
+
+    for (int start = 0; start < numSamples; start += blockSize)
+    {
+        // Vista sobre una parte del buffer, sin copiar: processBlock ve un bloque de a lo sumo blockSize
+        juce::AudioBuffer<float> block(buffer.getArrayOfWritePointers(), 2, start, juce::jmin(blockSize, numSamples - start));
+        processor.processBlock(block, midi);
+    }
+}
+
+BatchResult BatchRenderer::renderAll(const juce::Array<juce::File>& inputs) const
+{
+    BatchResult result;
+    std::atomic<int> succeeded{ 0 }, failed{ 0 };
+    juce::CriticalSection errorLock;
+
+    const auto start = juce::Time::getMillisecondCounterHiRes();
+
+    // Cuantas entradas van a cada salida, con la ruta normalizada como la compara el sistema de archivos
+    const auto outputKey = [this](const juce::File& input) {
+        const auto path = getOutputFileFor(input).getFullPathName();
+        return juce::File::areFileNamesCaseSensitive() ? path : path.toLowerCase();
+    };
+
+    std::map<juce::String, int> outputUses;
+    for (const auto& input : inputs)
+        ++outputUses[outputKey(input)];
+
+    juce::Array<juce::File> toRender;
+
+    for (const auto& input : inputs)
+    {
+        const auto output = getOutputFileFor(input);
+
+        if (input == output)
+            result.errors.add("La salida pisaria la entrada: " + input.getFullPathName());
+        else if (outputUses[outputKey(input)] > 1)
+            result.errors.add("Varias entradas irian a la misma salida " + output.getFullPathName() + ": " + input.getFullPathName());
+        else
+        {
+            toRender.add(input);
+            continue;
+        }
+
+        ++failed;
+    }
+
+    {
+        juce::ThreadPool pool(juce::jmax(1, settings.numThreads));
+
+        for (const auto& input : toRender)
+        {
+            pool.addJob([this, input, &succeeded, &failed, &errorLock, &result]
+                {
+                    auto r = renderFile(input, getOutputFileFor(input));
+
+                    if (r.wasOk())
+                    {
+                        ++succeeded;
+                        return;
+                    }
+
+                    ++failed;
+                    const juce::ScopedLock sl(errorLock);
+                    result.errors.add(r.getErrorMessage());
+                });
+        }
+
+        while (pool.getNumJobs() > 0)
+            juce::Thread::sleep(10);
+    }
+
+    result.seconds = (juce::Time::getMillisecondCounterHiRes() - start) / 1000.0;
+    result.succeeded = succeeded.load();
+    result.failed = failed.load();
+    return result;
+}
@@ -0,0 +1,67 @@
+/*
+  ==============================================================================
+
+    BatchRenderer.h
+    Created: 18 Oct 2026 10:12:40am
+    Author:  usuario
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+// Render por lotes sin DAW ni editor:
+// 1. El estado del EQ se arma una sola vez (blob de getStateInformation o JSON con los campos de ChainSettings).
+// 2. Cada archivo es un trabajo del ThreadPool, con su propio SimpleEQAudioProcessor, lector y escritor.
+// 3. La salida usa el mismo formato que la entrada (WAV, AIFF, FLAC...).
+
+struct RenderSettings
+{
+    juce::MemoryBlock state;            // Estado del processor, tal como lo devuelve getStateInformation
+    juce::File outputDirectory;
+    int blockSize = 512;
+    int numThreads = juce::SystemStats::getNumCpus();
+};
+
+class SimpleEQAudioProcessor;
+
+struct BatchResult
+{
+    int succeeded = 0, failed = 0;
+    double seconds = 0.0;
+    juce::StringArray errors;
+
+    double getFilesPerSecond() const { return seconds > 0.0 ? (succeeded + failed) / seconds : 0.0; }
+};
+
+class BatchRenderer
+{
+public:
+    explicit BatchRenderer(RenderSettings settingsToUse);
+
+    // Carga el estado desde un archivo binario guardado por el plugin
+    static juce::Result loadStateFromBlob(const juce::File& file, juce::MemoryBlock& state);
+
+    // Carga el estado desde un JSON con las claves de ChainSettings (peakFreq, lowCutSlope, ...)
+    static juce::Result loadStateFromSettingsJson(const juce::File& file, juce::MemoryBlock& state);
+
+    // Renderiza un solo archivo. Se puede llamar desde cualquier hilo.
+    juce::Result renderFile(const juce::File& input, const juce::File& output) const;
+
+    // Renderiza todos los archivos en paralelo, un archivo por worker.
+    // Antes de empezar se descartan (como fallidas) las entradas cuya salida pisaria la entrada misma, y todas las que
+    // irian al mismo archivo de salida (mismo nombre en carpetas distintas): dos workers escribirian el mismo archivo.
+    BatchResult renderAll(const juce::Array<juce::File>& inputs) const;
+
+    juce::File getOutputFileFor(const juce::File& input) const;
+
+    // Deja un processor listo para render offline como en renderFile: modo no tiempo real, estado de settings, preparado
+    static void prepareOfflineProcessor(SimpleEQAudioProcessor& processor, const RenderSettings& settings, double sampleRate);
+
+    // Procesa numSamples de buffer (2 canales) en bloques de blockSize, igual que renderFile
+    static void processInBlocks(SimpleEQAudioProcessor& processor, juce::AudioBuffer<float>& buffer, int numSamples, int blockSize);
+
+private:
+    RenderSettings settings;
+};
@@ -0,0 +1,219 @@
+/*
+  ==============================================================================
+
+    Benchmark.cpp
+    Created: 20 Oct 2026 9:21:17am
+    Author:  usuario
+
+  ==============================================================================
+*/
+
+#include "Benchmark.h"
+#include "AllocationCounter.h"
+#include "../../../Source/PluginProcessor.h"
+
+#if JUCE_INTEL && (JUCE_GCC || JUCE_CLANG)
+ #include <x86intrin.h>
+#elif JUCE_INTEL && JUCE_MSVC
+ #include <intrin.h>
+#endif
+
+namespace
+{
+    juce::uint64 readCycleCounter()
+    {
+       #if JUCE_INTEL
+        return (juce::uint64)__rdtsc();
+       #else
+        return 0;
+       #endif
+    }
+
+    ChainSettings makeSettings(int slope, bool bypassed)
+    {
+        ChainSettings settings;
+        settings.lowCutFreq = 80.0f;
+        settings.highCutFreq = 12000.0f;
+        settings.peakFreq = 1000.0f;
+        settings.peakGainInDecibels = 6.0f;
+        settings.peakQuality = 1.0f;
+        settings.lowCutSlope = static_cast<Slope>(slope);
+        settings.highCutSlope = static_cast<Slope>(slope);
+        settings.lowCutBypassed = settings.peakBypassed = settings.highCutBypassed = bypassed;
+        return settings;
+    }
+
+    void setParameter(juce::AudioProcessorValueTreeState& apvts, const juce::String& paramID, float value)
+    {
+        auto* param = apvts.getParameter(paramID);
+        jassert(param != nullptr);
+        param->setValueNotifyingHost(param->convertTo0to1(value));
+    }
+
+    void applySettings(juce::AudioProcessorValueTreeState& apvts, const ChainSettings& settings)
+    {
+        setParameter(apvts, "LowCut Freq", settings.lowCutFreq);
+        setParameter(apvts, "HighCut Freq", settings.highCutFreq);
+        setParameter(apvts, "Peak Freq", settings.peakFreq);
+        setParameter(apvts, "Peak Gain", settings.peakGainInDecibels);
+        setParameter(apvts, "Peak Q", settings.peakQuality);
+        setParameter(apvts, "LowCut Slope", (float)settings.lowCutSlope);
+        setParameter(apvts, "HighCut Slope", (float)settings.highCutSlope);
+        setParameter(apvts, "LowCut Bypass", settings.lowCutBypassed ? 1.0f : 0.0f);
+        setParameter(apvts, "Peak Bypass", settings.peakBypassed ? 1.0f : 0.0f);
+        setParameter(apvts, "HighCut Bypass", settings.highCutBypassed ? 1.0f : 0.0f);
+    }
+
+    // Acumula tiempo, ciclos y allocations de la parte medida de cada bloque
+    struct Measurement
+    {
+        juce::int64 ticks = 0;
+        juce::uint64 cycles = 0;
+        juce::int64 allocations = 0;
+
+        template<typename Function>
+        void measure(Function&& function)
+        {
+            AllocationCounter::start();
+            const auto startCycles = readCycleCounter();
+            const auto startTicks = juce::Time::getHighResolutionTicks();
+
+            function();
+
+            const auto endTicks = juce::Time::getHighResolutionTicks();
+            const auto endCycles = readCycleCounter();
+            allocations += AllocationCounter::stop();
+
+            ticks += endTicks - startTicks;
+            cycles += endCycles - startCycles;
+        }
+    };
+}
+
+BenchmarkResult runBenchmarkCase(BenchmarkTarget target, int blockSize, double sampleRate, int slope,
+                                 bool bypassed, double automationDensity, const BenchmarkOptions& options)
+{
+    constexpr int numWarmupBlocks = 16;
+    const auto numBlocks = juce::jmax(64, (int)(options.secondsPerCase * sampleRate / blockSize));
+
+    juce::Random random(options.seed);
+    auto settings = makeSettings(slope, bypassed);
+
+    // Ruido precalculado: cada bloque arranca de la misma entrada y la copia queda fuera de la medicion
+    juce::AudioBuffer<float> noise(2, blockSize), buffer(2, blockSize);
+    for (int ch = 0; ch < 2; ++ch)
+        for (int i = 0; i < blockSize; ++i)
+            noise.setSample(ch, i, random.nextFloat() * 2.0f - 1.0f);
+
+    juce::MidiBuffer midi;
+    Measurement measurement;
+
+    auto shouldAutomate = [&] { return automationDensity > 0.0 && random.nextDouble() < automationDensity; };
+    auto nextPeakFreq = [&] { return 200.0f + random.nextFloat() * 4800.0f; };
+
+    if (target == BenchmarkTarget::processBlock)
+    {
+        SimpleEQAudioProcessor processor;
+        processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+        applySettings(processor.apvts, settings);
+        processor.prepareToPlay(sampleRate, blockSize);
+
+        for (int block = 0; block < numWarmupBlocks + numBlocks; ++block)
+        {
+            buffer.makeCopyOf(noise, true);
+
+            // El cambio de parametro lo hace el "host", fuera de la medicion
+            if (shouldAutomate())
+                setParameter(processor.apvts, "Peak Freq", nextPeakFreq());
+
+            if (block < numWarmupBlocks)
+                processor.processBlock(buffer, midi);
+            else
+                measurement.measure([&] { processor.processBlock(buffer, midi); });
+        }
+
+        processor.releaseResources();
+    }
+    else
+    {
+        MonoChain leftChain, rightChain;
+
+        juce::dsp::ProcessSpec spec;
+        spec.maximumBlockSize = (juce::uint32)blockSize;
+        spec.numChannels = 1;
+        spec.sampleRate = sampleRate;
+
+        leftChain.prepare(spec);
+        rightChain.prepare(spec);
+        updateMonoChain(leftChain, settings, sampleRate);
+        updateMonoChain(rightChain, settings, sampleRate);
+
+        auto processChains = [&](bool automate)
+            {
+                // Con la cadena sola, el costo de la automatizacion es recalcular los coeficientes
+                if (automate)
+                {
+                    updateMonoChain(leftChain, settings, sampleRate);
+                    updateMonoChain(rightChain, settings, sampleRate);
+                }
+
+                juce::dsp::AudioBlock<float> audioBlock(buffer);
+                auto leftBlock = audioBlock.getSingleChannelBlock(0);
+                auto rightBlock = audioBlock.getSingleChannelBlock(1);
+
+                leftChain.process(juce::dsp::ProcessContextReplacing<float>(leftBlock));
+                rightChain.process(juce::dsp::ProcessContextReplacing<float>(rightBlock));
+            };
+
+        for (int block = 0; block < numWarmupBlocks + numBlocks; ++block)
+        {
+            buffer.makeCopyOf(noise, true);
+
+            const auto automate = shouldAutomate();
+            if (automate)
+                settings.peakFreq = nextPeakFreq();
+
+            if (block < numWarmupBlocks)
+                processChains(automate);
+            else
+                measurement.measure([&] { processChains(automate); });
+        }
+    }
+
+    const auto numSamples = (double)numBlocks * blockSize;
+
+    BenchmarkResult result;
+    result.nsPerSample = juce::Time::highResolutionTicksToSeconds(measurement.ticks) * 1.0e9 / numSamples;
+    result.cyclesPerSample = (double)measurement.cycles / numSamples;
+    result.allocationsPerBlock = (double)measurement.allocations / numBlocks;
+    return result;
+}
+
+void runBenchmarks(const BenchmarkOptions& options, std::ostream& out)
+{
+    for (auto target : { BenchmarkTarget::processBlock, BenchmarkTarget::monoChain })
+        for (auto sampleRate : options.sampleRates)
+            for (auto blockSize : options.blockSizes)
+                for (auto slope : options.slopes)
+                    for (auto bypassed : options.bypassStates)
+                        for (auto automationDensity : options.automationDensities)
+                        {
+                            auto result = runBenchmarkCase(target, blockSize, sampleRate, slope, bypassed, automationDensity, options);
+
+                            auto* obj = new juce::DynamicObject();
+                            obj->setProperty("target", target == BenchmarkTarget::processBlock ? "processBlock" : "monoChain");
+                            obj->setProperty("sampleRate", sampleRate);
+                            obj->setProperty("blockSize", blockSize);
+                            obj->setProperty("slope", slope);
+                            obj->setProperty("bypassed", bypassed);
+                            obj->setProperty("automationDensity", automationDensity);
+                            obj->setProperty("nsPerSample", result.nsPerSample);
+                            obj->setProperty("cyclesPerSample", result.cyclesPerSample);
+
+                            // Las allocations solo se cuentan en la configuracion RealtimeChecks (ver AllocationCounter.h)
+                            if (AllocationCounter::isAvailable)
+                                obj->setProperty("allocationsPerBlock", result.allocationsPerBlock);
+
+                            out << juce::JSON::toString(juce::var(obj), true) << std::endl;
+                        }
+}
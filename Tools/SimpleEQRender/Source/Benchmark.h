@@ -0,0 +1,50 @@
+/*
+  ==============================================================================
+
+    Benchmark.h
+    Created: 20 Oct 2026 9:21:17am
+    Author:  usuario
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <ostream>
+
+// Micro-benchmark de processBlock y de la MonoChain sola.
+// Recorre la matriz block size x sample rate x slope x bypass x densidad de automatizacion
+// y escribe una linea JSON por caso (ns/muestra, ciclos/muestra, allocations por bloque).
+// Las allocations solo salen en la configuracion RealtimeChecks, que instrumenta malloc y operator new; los tiempos
+// que valen son los de Release, sin esa instrumentacion.
+
+struct BenchmarkOptions
+{
+    std::vector<int> blockSizes{ 16, 32, 64, 128, 256, 512, 1024, 2048, 4096 };
+    std::vector<double> sampleRates{ 44100.0, 48000.0, 96000.0, 192000.0 };
+    std::vector<int> slopes{ 0, 1, 2, 3 };
+    std::vector<bool> bypassStates{ false, true };
+    std::vector<double> automationDensities{ 0.0, 0.1, 1.0 };   // Fraccion de bloques con un parametro automatizado
+
+    double secondsPerCase = 2.0;
+    juce::int64 seed = 1234;
+};
+
+struct BenchmarkResult
+{
+    double nsPerSample = 0.0;
+    double cyclesPerSample = 0.0;   // 0 si la plataforma no tiene contador de ciclos
+    double allocationsPerBlock = 0.0;
+};
+
+enum class BenchmarkTarget
+{
+    processBlock,
+    monoChain
+};
+
+BenchmarkResult runBenchmarkCase(BenchmarkTarget target, int blockSize, double sampleRate, int slope,
+                                 bool bypassed, double automationDensity, const BenchmarkOptions& options);
+
+// Corre toda la matriz y escribe JSON lines en 'out'
+void runBenchmarks(const BenchmarkOptions& options, std::ostream& out);
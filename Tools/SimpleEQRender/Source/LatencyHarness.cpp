@@ -0,0 +1,222 @@
+/*
+  ==============================================================================
+
+    LatencyHarness.cpp
+    Created: 20 Oct 2026 4:02:48pm
+    Author:  usuario
+
+  ==============================================================================
+*/
+
+#include "LatencyHarness.h"
+#include "../../../Source/PluginProcessor.h"
+#include <thread>
+
+#if JUCE_LINUX
+ #include <pthread.h>
+ #include <sched.h>
+ #include <time.h>
+#endif
+
+namespace
+{
+    bool makeCurrentThreadRealtime(int priority)
+    {
+       #if JUCE_LINUX
+        sched_param param{};
+        param.sched_priority = priority;
+        return pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) == 0;
+       #else
+        juce::ignoreUnused(priority);
+        return false;
+       #endif
+    }
+
+    // Reloj monotono en nanosegundos y espera hasta un instante absoluto de ese reloj
+   #if JUCE_LINUX
+    juce::int64 monotonicNanos()
+    {
+        timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (juce::int64)ts.tv_sec * 1000000000 + ts.tv_nsec;
+    }
+
+    void sleepUntil(juce::int64 deadlineNanos)
+    {
+        timespec ts;
+        ts.tv_sec = (time_t)(deadlineNanos / 1000000000);
+        ts.tv_nsec = (long)(deadlineNanos % 1000000000);
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr);
+    }
+   #else
+    juce::int64 monotonicNanos()
+    {
+        return (juce::int64)(juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks()) * 1.0e9);
+    }
+
+    void sleepUntil(juce::int64 deadlineNanos)
+    {
+        for (auto remaining = deadlineNanos - monotonicNanos(); remaining > 0; remaining = deadlineNanos - monotonicNanos())
+            juce::Thread::sleep((int)(remaining / 1000000));
+    }
+   #endif
+
+    double percentile(const std::vector<double>& sorted, double p)
+    {
+        if (sorted.empty())
+            return 0.0;
+
+        auto index = (size_t)juce::jlimit(0.0, (double)sorted.size() - 1.0, std::ceil(p * (double)sorted.size()) - 1.0);
+        return sorted[index];
+    }
+}
+
+LatencyResult runLatencyHarness(const LatencyOptions& options, const juce::MemoryBlock& state)
+{
+    SimpleEQAudioProcessor processor;
+    processor.setRateAndBufferSizeDetails(options.sampleRate, options.blockSize);
+
+    if (!state.isEmpty())
+        processor.setStateInformation(state.getData(), (int)state.getSize());
+
+    processor.prepareToPlay(options.sampleRate, options.blockSize);
+
+    if (options.traceFile != juce::File())
+        processor.traceRecorder->start(options.traceFile, options.traceThreads);
+
+    const auto numBlocks = juce::jmax(1, (int)(options.seconds * options.sampleRate / options.blockSize));
+    const auto periodNanos = (juce::int64)(1.0e9 * options.blockSize / options.sampleRate);
+
+    // Todo preasignado: el hilo de audio solo escribe en estos vectores
+    std::vector<double> durations((size_t)numBlocks, 0.0);
+    std::atomic<int> deadlineMisses{ 0 };
+    std::atomic<bool> realtimeScheduling{ false }, finished{ false };
+
+    juce::AudioBuffer<float> noise(2, options.blockSize), buffer(2, options.blockSize);
+    juce::Random noiseRandom(options.seed);
+    for (int ch = 0; ch < 2; ++ch)
+        for (int i = 0; i < options.blockSize; ++i)
+            noise.setSample(ch, i, noiseRandom.nextFloat() * 2.0f - 1.0f);
+
+    // Automatizacion al azar, planificada de antemano por bloque: cada 1 a 20 ms de tiempo de audio un parametro cambia.
+    // Depende solo de la semilla, asi dos corridas con la misma semilla aplican los mismos cambios en los mismos bloques.
+    struct AutomationChange
+    {
+        int block;
+        juce::RangedAudioParameter* param;
+        float value;
+    };
+
+    std::vector<AutomationChange> automation;
+    {
+        juce::Random random(options.seed + 1);
+        const juce::StringArray paramIDs{ "LowCut Freq", "HighCut Freq", "Peak Freq", "Peak Gain", "Peak Q", "LowCut Slope", "HighCut Slope" };
+        const auto blockMs = 1000.0 * options.blockSize / options.sampleRate;
+
+        for (double ms = 0.0; ms < numBlocks * blockMs; ms += 1 + random.nextInt(20))
+        {
+            auto* param = processor.apvts.getParameter(paramIDs[random.nextInt(paramIDs.size())]);
+            automation.push_back({ (int)(ms / blockMs), param, random.nextFloat() });
+        }
+    }
+
+    // Consumidor equivalente al editor: vacia las FIFOs del analizador cada ~16 ms.
+    // Se anuncia como un editor abierto para que processBlock alimente el analizador, que es el peor caso.
+    processor.setAnalyzerEditorOpen(true);
+
+    std::thread consumerThread([&]
+        {
+            Trace::Recorder::nameCurrentThread("Consumer");
+            std::vector<float> incoming((size_t)options.blockSize);
+
+            while (!finished.load())
+            {
+                for (auto* fifo : { &processor.leftChannelFifo, &processor.rightChannelFifo })
+                    while (fifo->pull(incoming.data(), options.blockSize)) {}
+
+                juce::Thread::sleep(16);
+            }
+        });
+
+    std::thread audioThread([&]
+        {
+            realtimeScheduling = makeCurrentThreadRealtime(options.realtimePriority);
+
+            juce::MidiBuffer midi;
+            auto deadline = monotonicNanos() + periodNanos;
+
+            size_t nextChange = 0;
+
+            for (int block = 0; block < numBlocks; ++block)
+            {
+                buffer.makeCopyOf(noise, true);
+
+                // El "host" aplica los cambios de este bloque justo antes de procesarlo, fuera de la medicion
+                for (; nextChange < automation.size() && automation[nextChange].block == block; ++nextChange)
+                    automation[nextChange].param->setValueNotifyingHost(automation[nextChange].value);
+
+                const auto start = monotonicNanos();
+                processor.processBlock(buffer, midi);
+                const auto end = monotonicNanos();
+
+                durations[(size_t)block] = (double)(end - start) / 1000.0;
+
+                // Si el bloque termina despues de su deadline el host ya se habria quedado sin audio
+                if (end > deadline)
+                    ++deadlineMisses;
+
+                sleepUntil(deadline);
+                deadline += periodNanos;
+            }
+        });
+
+    audioThread.join();
+    finished = true;
+    consumerThread.join();
+    processor.setAnalyzerEditorOpen(false);
+    processor.traceRecorder->stop();
+    processor.releaseResources();
+
+    LatencyResult result;
+    result.numBlocks = numBlocks;
+    result.deadlineMisses = deadlineMisses.load();
+    result.realtimeScheduling = realtimeScheduling.load();
+
+    result.histogram.assign(24, 0);
+    for (auto d : durations)
+    {
+        auto bucket = d < 1.0 ? 0 : juce::jmin((int)result.histogram.size() - 1, (int)std::log2(d));
+        ++result.histogram[(size_t)bucket];
+    }
+
+    std::sort(durations.begin(), durations.end());
+    result.p50 = percentile(durations, 0.5);
+    result.p99 = percentile(durations, 0.99);
+    result.p999 = percentile(durations, 0.999);
+    result.max = durations.back();
+
+    return result;
+}
+
+void writeLatencyResult(const LatencyOptions& options, const LatencyResult& result, std::ostream& out)
+{
+    auto* obj = new juce::DynamicObject();
+    obj->setProperty("blockSize", options.blockSize);
+    obj->setProperty("sampleRate", options.sampleRate);
+    obj->setProperty("seed", options.seed);
+    obj->setProperty("blocks", result.numBlocks);
+    obj->setProperty("realtimeScheduling", result.realtimeScheduling);
+    obj->setProperty("budgetUs", 1.0e6 * options.blockSize / options.sampleRate);
+    obj->setProperty("p50Us", result.p50);
+    obj->setProperty("p99Us", result.p99);
+    obj->setProperty("p999Us", result.p999);
+    obj->setProperty("maxUs", result.max);
+    obj->setProperty("deadlineMisses", result.deadlineMisses);
+
+    juce::Array<juce::var> histogram;
+    for (auto count : result.histogram)
+        histogram.add(count);
+    obj->setProperty("histogramLog2Us", histogram);
+
+    out << juce::JSON::toString(juce::var(obj), true) << std::endl;
+}
@@ -0,0 +1,45 @@
+/*
+  ==============================================================================
+
+    LatencyHarness.h
+    Created: 20 Oct 2026 4:02:48pm
+    Author:  usuario
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "../../../Source/Trazas.h"
+#include <ostream>
+
+// Mide la latencia peor caso de processBlock en condiciones parecidas a un host real:
+// 1. Un hilo "de audio" (SCHED_FIFO en Linux) llama a processBlock con la cadencia real del buffer.
+// 2. Los parametros del APVTS cambian al azar, como la automatizacion de un DAW. Los cambios se planifican
+//    de antemano por bloque (solo dependen de la semilla) y se aplican justo antes de cada processBlock.
+// 3. Otro hilo vacia leftChannelFifo y rightChannelFifo, como lo hace el editor.
+// Todo depende de una semilla, asi que dos corridas con las mismas opciones hacen el mismo trabajo.
+
+struct LatencyOptions
+{
+    int blockSize = 128;
+    double sampleRate = 48000.0;
+    double seconds = 30.0;
+    juce::int64 seed = 1234;
+    int realtimePriority = 80;
+    juce::File traceFile;   // si no esta vacio, se graba una traza de Chrome de toda la corrida
+    int traceThreads = Trace::Recorder::defaultMaxThreads;
+};
+
+struct LatencyResult
+{
+    int numBlocks = 0;
+    int deadlineMisses = 0;
+    bool realtimeScheduling = false;
+    double p50 = 0.0, p99 = 0.0, p999 = 0.0, max = 0.0;    // microsegundos
+    std::vector<int> histogram;                             // cubetas de [2^i, 2^(i+1)) microsegundos
+};
+
+LatencyResult runLatencyHarness(const LatencyOptions& options, const juce::MemoryBlock& state);
+
+void writeLatencyResult(const LatencyOptions& options, const LatencyResult& result, std::ostream& out);
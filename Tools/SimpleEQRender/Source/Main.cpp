@@ -0,0 +1,272 @@
+/*
+  ==============================================================================
+
+    This file contains the basic startup code for a JUCE application.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "BatchRenderer.h"
+#include "StreamingRenderer.h"
+#include "ParallelIIRRenderer.h"
+#include "Benchmark.h"
+#include "LatencyHarness.h"
+#include "RealtimeChecks.h"
+
+// Herramienta de consola para usar SimpleEQ sin DAW.
+// Las opciones con valor van siempre con '=' (--out=carpeta), todo lo demas se toma como archivo de entrada.
+
+static juce::Array<juce::File> getInputFiles(const juce::ArgumentList& args)
+{
+    juce::Array<juce::File> files;
+
+    // El primer argumento es el nombre del comando
+    for (int i = 1; i < args.size(); ++i)
+        if (!args[i].isOption())
+            files.add(args[i].resolveAsFile());
+
+    return files;
+}
+
+static RenderSettings getRenderSettings(const juce::ArgumentList& args)
+{
+    RenderSettings settings;
+
+    if (args.containsOption("--state"))
+    {
+        auto r = BatchRenderer::loadStateFromBlob(args.getExistingFileForOption("--state"), settings.state);
+        if (r.failed())
+            juce::ConsoleApplication::fail(r.getErrorMessage());
+    }
+    else if (args.containsOption("--settings"))
+    {
+        auto r = BatchRenderer::loadStateFromSettingsJson(args.getExistingFileForOption("--settings"), settings.state);
+        if (r.failed())
+            juce::ConsoleApplication::fail(r.getErrorMessage());
+    }
+    else
+    {
+        juce::ConsoleApplication::fail("Falta --state=<archivo> o --settings=<archivo.json>");
+    }
+
+    if (!args.containsOption("--out"))
+        juce::ConsoleApplication::fail("Falta --out=<carpeta>");
+
+    settings.outputDirectory = juce::File::getCurrentWorkingDirectory().getChildFile(args.getValueForOption("--out"));
+    if (!settings.outputDirectory.createDirectory())
+        juce::ConsoleApplication::fail("No se pudo crear la carpeta de salida");
+
+    if (args.containsOption("--threads"))
+        settings.numThreads = juce::jmax(1, args.getValueForOption("--threads").getIntValue());
+
+    if (args.containsOption("--block"))
+        settings.blockSize = juce::jlimit(16, 8192, args.getValueForOption("--block").getIntValue());
+
+    return settings;
+}
+
+static void runRender(const juce::ArgumentList& args)
+{
+    auto settings = getRenderSettings(args);
+    auto inputs = getInputFiles(args);
+
+    if (inputs.isEmpty())
+        juce::ConsoleApplication::fail("No hay archivos de entrada");
+
+    const auto numThreads = settings.numThreads;
+    BatchRenderer renderer(std::move(settings));
+    auto result = renderer.renderAll(inputs);
+
+    for (const auto& error : result.errors)
+        std::cerr << error << std::endl;
+
+    std::cout << result.succeeded << " ok, " << result.failed << " con error, "
+              << result.seconds << " s, " << result.getFilesPerSecond() << " archivos/s con "
+              << numThreads << " hilos" << std::endl;
+
+    if (result.failed > 0)
+        juce::ConsoleApplication::fail({}, 1);
+}
+
+static void runStream(const juce::ArgumentList& args)
+{
+    auto settings = getRenderSettings(args);
+    auto inputs = getInputFiles(args);
+
+    if (inputs.isEmpty())
+        juce::ConsoleApplication::fail("No hay archivos de entrada");
+
+    // Archivos largos: uno por vez, con lectura, DSP y escritura solapados
+    StreamingRenderer renderer(settings);
+
+    for (const auto& input : inputs)
+    {
+        auto r = renderer.renderFile(input, settings.outputDirectory.getChildFile(input.getFileName()));
+        if (r.failed())
+            juce::ConsoleApplication::fail(r.getErrorMessage());
+
+        std::cout << input.getFileName() << ": " << renderer.getLastMegabytesPerSecond() << " MB/s" << std::endl;
+    }
+}
+
+static void runParallel(const juce::ArgumentList& args)
+{
+    auto settings = getRenderSettings(args);
+    auto inputs = getInputFiles(args);
+
+    if (inputs.isEmpty())
+        juce::ConsoleApplication::fail("No hay archivos de entrada");
+
+    // Un archivo por vez, repartido en chunks entre todos los hilos
+    ParallelIIRRenderer renderer(settings);
+
+    if (args.containsOption("--chunk"))
+        renderer.setChunkSize(args.getValueForOption("--chunk").getIntValue());
+
+    const auto verify = args.containsOption("--verify");
+
+    for (const auto& input : inputs)
+    {
+        const auto start = juce::Time::getMillisecondCounterHiRes();
+
+        auto r = renderer.renderFile(input, settings.outputDirectory.getChildFile(input.getFileName()), verify);
+        if (r.failed())
+            juce::ConsoleApplication::fail(r.getErrorMessage());
+
+        std::cout << input.getFileName() << ": " << (juce::Time::getMillisecondCounterHiRes() - start) / 1000.0 << " s";
+        if (verify)
+            std::cout << ", error maximo contra el render del plugin " << renderer.getLastMaxError();
+        std::cout << std::endl;
+    }
+}
+
+static void runBench(const juce::ArgumentList& args)
+{
+    BenchmarkOptions options;
+
+    if (args.containsOption("--seconds"))
+        options.secondsPerCase = juce::jmax(0.1, args.getValueForOption("--seconds").getDoubleValue());
+
+    // Subconjunto chico de la matriz para una corrida rapida
+    if (args.containsOption("--quick"))
+    {
+        options.blockSizes = { 64, 512, 4096 };
+        options.sampleRates = { 48000.0, 192000.0 };
+        options.slopes = { 0, 3 };
+        options.automationDensities = { 0.0, 1.0 };
+    }
+
+    runBenchmarks(options, std::cout);
+}
+
+static void runLatency(const juce::ArgumentList& args)
+{
+    LatencyOptions options;
+
+    if (args.containsOption("--block"))
+        options.blockSize = juce::jlimit(16, 8192, args.getValueForOption("--block").getIntValue());
+
+    if (args.containsOption("--rate"))
+        options.sampleRate = juce::jlimit(8000.0, 384000.0, args.getValueForOption("--rate").getDoubleValue());
+
+    if (args.containsOption("--seconds"))
+        options.seconds = juce::jmax(0.1, args.getValueForOption("--seconds").getDoubleValue());
+
+    if (args.containsOption("--seed"))
+        options.seed = args.getValueForOption("--seed").getLargeIntValue();
+
+    if (args.containsOption("--trace"))
+        options.traceFile = args.getFileForOption("--trace");
+
+    if (args.containsOption("--trace-threads"))
+        options.traceThreads = juce::jlimit(1, Trace::Recorder::maxThreadSlots, args.getValueForOption("--trace-threads").getIntValue());
+
+    // El estado es opcional: sin el se usan los valores por defecto de los parametros
+    juce::MemoryBlock state;
+    juce::Result r = juce::Result::ok();
+
+    if (args.containsOption("--state"))
+        r = BatchRenderer::loadStateFromBlob(args.getExistingFileForOption("--state"), state);
+    else if (args.containsOption("--settings"))
+        r = BatchRenderer::loadStateFromSettingsJson(args.getExistingFileForOption("--settings"), state);
+
+    if (r.failed())
+        juce::ConsoleApplication::fail(r.getErrorMessage());
+
+    auto result = runLatencyHarness(options, state);
+
+    if (!result.realtimeScheduling)
+        std::cerr << "Aviso: no se pudo usar SCHED_FIFO (hacen falta permisos de tiempo real), los resultados son orientativos" << std::endl;
+
+    writeLatencyResult(options, result, std::cout);
+
+    if (result.deadlineMisses > 0)
+        juce::ConsoleApplication::fail({}, 2);
+}
+
+#if SIMPLEEQ_REALTIME_CHECKS
+static void runRealtimeCheck(const juce::ArgumentList& args)
+{
+    const auto blockSize = args.containsOption("--block") ? juce::jlimit(16, 8192, args.getValueForOption("--block").getIntValue()) : 128;
+    const auto sampleRate = args.containsOption("--rate") ? args.getValueForOption("--rate").getDoubleValue() : 48000.0;
+    const auto numBlocks = args.containsOption("--blocks") ? juce::jmax(1, args.getValueForOption("--blocks").getIntValue()) : 10000;
+    const auto seed = args.containsOption("--seed") ? args.getValueForOption("--seed").getLargeIntValue() : (juce::int64)1234;
+
+    // Si hay una violacion el proceso aborta adentro con el stack
+    const auto processed = runRealtimeChecks(blockSize, sampleRate, numBlocks, seed);
+    std::cout << processed << " bloques sin allocations ni locks en el hilo de audio" << std::endl;
+}
+#endif
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    // El APVTS usa un Timer, asi que necesita un MessageManager aunque no haya GUI
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::ConsoleApplication app;
+    app.addHelpCommand("--help|-h", "Uso: SimpleEQRender <comando> [opciones] archivos...", true);
+
+    app.addCommand({ "render",
+                     "render --state=<blob>|--settings=<json> --out=<carpeta> [--threads=N] [--block=N] archivos...",
+                     "Procesa archivos de audio con SimpleEQ en paralelo.",
+                     "Procesa cada archivo con SimpleEQ, un archivo por hilo, y lo guarda en la carpeta de salida con el mismo formato.",
+                     runRender });
+
+    app.addCommand({ "stream",
+                     "stream --state=<blob>|--settings=<json> --out=<carpeta> [--block=N] archivos...",
+                     "Procesa archivos WAV/AIFF muy largos con memoria constante.",
+                     "Lee con un reader mapeado en memoria, procesa y escribe en tres etapas solapadas con buffers fijos.",
+                     runStream });
+
+    app.addCommand({ "parallel",
+                     "parallel --state=<blob>|--settings=<json> --out=<carpeta> [--threads=N] [--chunk=N] [--verify] archivos...",
+                     "Filtra un archivo largo en paralelo por chunks, con correccion exacta del estado.",
+                     "Filtra cada chunk desde estado cero, propaga el estado real entre chunks con la matriz de transicion de la cascada y vuelve a filtrar desde ese estado. Con --verify compara contra el render offline del plugin (processBlock, como el comando render).",
+                     runParallel });
+
+    app.addCommand({ "bench",
+                     "bench [--seconds=N] [--quick]",
+                     "Micro-benchmark de processBlock y de la MonoChain.",
+                     "Recorre block size, sample rate, slope, bypass y densidad de automatizacion, y escribe una linea JSON por caso con ns/muestra, ciclos/muestra y, en la configuracion RealtimeChecks, allocations por bloque.",
+                     runBench });
+
+    app.addCommand({ "latency",
+                     "latency [--block=N] [--rate=N] [--seconds=N] [--seed=N] [--trace=<json>] [--trace-threads=N] [--state=<blob>|--settings=<json>]",
+                     "Latencia peor caso y jitter de processBlock en un hilo SCHED_FIFO.",
+                     "Llama a processBlock con la cadencia real del buffer, con automatizacion al azar planificada por bloque segun la semilla, mientras otro hilo vacia las FIFOs del analizador. "
+                     "Escribe p50/p99/p99.9/max, histograma y deadlines perdidos como JSON; sale con codigo 2 si hubo deadlines perdidos.",
+                     runLatency });
+
+   #if SIMPLEEQ_REALTIME_CHECKS
+    // Solo en la configuracion RealtimeChecks: los hooks de malloc y compania no van en el ejecutable normal
+    app.addCommand({ "rtcheck",
+                     "rtcheck [--block=N] [--rate=N] [--blocks=N] [--seed=N]",
+                     "Falla si processBlock aloca memoria o toma un lock.",
+                     "Instala hooks en malloc/free, operator new/delete y pthread_mutex_lock y aborta con el stack si el hilo que corre processBlock los usa.",
+                     runRealtimeCheck });
+   #endif
+
+    return app.findAndRunCommand(argc, argv);
+}
@@ -0,0 +1,382 @@
+/*
+  ==============================================================================
+
+    ParallelIIRRenderer.cpp
+    Created: 19 Oct 2026 11:05:52am
+    Author:  usuario
+
+  ==============================================================================
+*/
+
+#include "ParallelIIRRenderer.h"
+#include "../../../Source/PluginProcessor.h"
+
+namespace
+{
+    std::vector<double> multiply(const std::vector<double>& a, const std::vector<double>& b, int n)
+    {
+        std::vector<double> result((size_t)(n * n), 0.0);
+
+        for (int r = 0; r < n; ++r)
+            for (int k = 0; k < n; ++k)
+            {
+                const auto ark = a[(size_t)(r * n + k)];
+                for (int c = 0; c < n; ++c)
+                    result[(size_t)(r * n + c)] += ark * b[(size_t)(k * n + c)];
+            }
+
+        return result;
+    }
+
+    // Corre function(0), ..., function(count - 1) como trabajos del pool y espera a que terminen todos
+    template<typename Function>
+    void runOnPool(juce::ThreadPool& pool, int count, Function&& function)
+    {
+        std::atomic<int> pending{ count };
+        juce::WaitableEvent allDone;
+
+        for (int job = 0; job < count; ++job)
+            pool.addJob([&function, &pending, &allDone, job]
+                {
+                    function(job);
+
+                    if (--pending == 0)
+                        allDone.signal();
+                });
+
+        if (count > 0)
+            allDone.wait();
+    }
+
+    std::unique_ptr<juce::AudioFormatReader> createReader(const juce::File& file)
+    {
+        juce::AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+        return std::unique_ptr<juce::AudioFormatReader>(formatManager.createReaderFor(file));
+    }
+
+    // Reader sobre el archivo entero mapeado en memoria, o nullptr si el formato no lo permite (FLAC, Ogg...)
+    std::unique_ptr<juce::AudioFormatReader> createMappedReader(const juce::File& file)
+    {
+        juce::AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+
+        auto* format = formatManager.findFormatForFileExtension(file.getFileExtension());
+        if (format == nullptr)
+            return nullptr;
+
+        std::unique_ptr<juce::MemoryMappedAudioFormatReader> reader(format->createMemoryMappedReader(file));
+        if (reader == nullptr || !reader->mapEntireFile())
+            return nullptr;
+
+        return std::unique_ptr<juce::AudioFormatReader>(reader.release());
+    }
+}
+
+//==============================================================================
+BiquadCascade BiquadCascade::fromChain(const ChainSettings& chainSettings, double sampleRate)
+{
+    // Los mismos biquads en doble precision que updateMonoChainInPlace le pone a la cadena de alta calidad,
+    // que es la que usa el processor en render offline. Secciones activas en el orden de la cadena.
+    BiquadCascade cascade;
+
+    auto add = [&cascade](const BiquadCoefficients& c) { cascade.sections.push_back({ c.b0, c.b1, c.b2, c.a1, c.a2 }); };
+
+    // Igual que setCutFilter: con Slope_12 solo la seccion 0, con Slope_48 las cuatro
+    auto addCut = [&](float frequency, Slope slope, bool isHighPass)
+        {
+            for (int section = 0; section <= static_cast<int>(slope); ++section)
+                add(makeCutBiquad(frequency, sampleRate, section, slope, isHighPass));
+        };
+
+    if (!chainSettings.lowCutBypassed)
+        addCut(chainSettings.lowCutFreq, chainSettings.lowCutSlope, true);
+
+    if (!chainSettings.peakBypassed)
+        add(makePeakBiquad(chainSettings, sampleRate));
+
+    if (!chainSettings.highCutBypassed)
+        addCut(chainSettings.highCutFreq, chainSettings.highCutSlope, false);
+
+    return cascade;
+}
+
+void BiquadCascade::process(float* samples, int numSamples, double* state) const
+{
+    const auto numSections = sections.size();
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        double x = samples[i];
+
+        for (size_t k = 0; k < numSections; ++k)
+        {
+            const auto& s = sections[k];
+            auto* st = state + 2 * k;
+
+            const double y = s.b0 * x + st[0];
+            st[0] = s.b1 * x - s.a1 * y + st[1];
+            st[1] = s.b2 * x - s.a2 * y;
+            x = y;
+        }
+
+        samples[i] = static_cast<float>(x);
+    }
+}
+
+std::vector<double> BiquadCascade::getTransitionMatrix(juce::int64 numSamples) const
+{
+    const auto n = getStateSize();
+
+    // Matriz de un paso: columna j = estado tras una muestra de entrada cero partiendo de e_j
+    std::vector<double> step((size_t)(n * n), 0.0);
+    std::vector<double> state((size_t)n);
+
+    for (int j = 0; j < n; ++j)
+    {
+        std::fill(state.begin(), state.end(), 0.0);
+        state[(size_t)j] = 1.0;
+
+        float zero = 0.0f;
+        process(&zero, 1, state.data());
+
+        for (int r = 0; r < n; ++r)
+            step[(size_t)(r * n + j)] = state[(size_t)r];
+    }
+
+    // A^L por cuadrados sucesivos
+    std::vector<double> result((size_t)(n * n), 0.0);
+    for (int i = 0; i < n; ++i)
+        result[(size_t)(i * n + i)] = 1.0;
+
+    for (auto e = numSamples; e > 0; e >>= 1)
+    {
+        if (e & 1)
+            result = multiply(result, step, n);
+
+        step = multiply(step, step, n);
+    }
+
+    return result;
+}
+
+//==============================================================================
+ParallelIIRRenderer::ParallelIIRRenderer(RenderSettings settingsToUse) : settings(std::move(settingsToUse))
+{
+}
+
+juce::Result ParallelIIRRenderer::renderFile(const juce::File& input, const juce::File& output, bool verify) const
+{
+    if (input == output)
+        return juce::Result::fail("La salida pisaria la entrada: " + input.getFullPathName());
+
+    auto reader = createReader(input);
+    if (reader == nullptr)
+        return juce::Result::fail("No se pudo abrir: " + input.getFullPathName());
+
+    if (reader->numChannels < 1 || reader->numChannels > 2)
+        return juce::Result::fail("Solo se admiten archivos mono o estereo: " + input.getFullPathName());
+
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+
+    auto* format = formatManager.findFormatForFileExtension(output.getFileExtension());
+    if (format == nullptr)
+        return juce::Result::fail("Formato de salida desconocido: " + output.getFullPathName());
+
+    output.deleteFile();
+    std::unique_ptr<juce::FileOutputStream> stream(output.createOutputStream());
+    if (stream == nullptr || stream->failedToOpen())
+        return juce::Result::fail("No se pudo crear: " + output.getFullPathName());
+
+    std::unique_ptr<juce::AudioFormatWriter> writer(format->createWriterFor(stream.get(),
+        reader->sampleRate,
+        reader->numChannels,
+        (int)reader->bitsPerSample,
+        reader->metadataValues,
+        0));
+
+    if (writer == nullptr)
+        return juce::Result::fail("El formato no acepta esta configuracion: " + output.getFullPathName());
+
+    stream.release();
+
+    // Los coeficientes salen del estado del plugin. El mismo processor, preparado como en BatchRenderer::renderFile,
+    // es la referencia de --verify.
+    SimpleEQAudioProcessor processor;
+    BatchRenderer::prepareOfflineProcessor(processor, settings, reader->sampleRate);
+
+    const auto cascade = BiquadCascade::fromChain(getChainSettings(processor.apvts), reader->sampleRate);
+    const auto stateSize = (size_t)cascade.getStateSize();
+
+    constexpr int numChannels = 2;
+    const auto length = reader->lengthInSamples;
+    const auto numChunks = (int)((length + chunkSize - 1) / chunkSize);
+    const auto numWorkers = juce::jlimit(1, juce::jmax(1, numChunks), settings.numThreads);
+
+    // Los readers no son thread-safe: uno por worker, abiertos antes de arrancar.
+    // Con reader mapeado (WAV, AIFF) el archivo se mapea entero y las dos pasadas leen del mapeo, sin decodificar dos
+    // veces. Si el formato no lo permite, la pasada 1 decodifica y guarda la entrada de cada chunk para la pasada 2:
+    // una sola decodificacion, a cambio de tener el archivo en memoria.
+    std::vector<std::unique_ptr<juce::AudioFormatReader>> workerReaders;
+    bool mapped = true;
+
+    for (int w = 0; w < numWorkers && mapped; ++w)
+    {
+        workerReaders.push_back(createMappedReader(input));
+        mapped = workerReaders.back() != nullptr;
+    }
+
+    if (!mapped)
+    {
+        workerReaders.clear();
+
+        for (int w = 0; w < numWorkers; ++w)
+        {
+            workerReaders.push_back(createReader(input));
+
+            if (workerReaders.back() == nullptr)
+                return juce::Result::fail("No se pudo abrir: " + input.getFullPathName());
+        }
+    }
+
+    std::vector<juce::AudioBuffer<float>> workerBuffers;
+    for (int w = 0; w < numWorkers; ++w)
+        workerBuffers.emplace_back(numChannels, chunkSize);
+
+    std::vector<juce::AudioBuffer<float>> chunkInputs(mapped ? 0 : (size_t)numChunks);
+
+    auto getChunkLength = [&](int chunk) { return (int)juce::jmin<juce::int64>(chunkSize, length - (juce::int64)chunk * chunkSize); };
+    auto getStateIndex = [](int chunk, int channel) { return (size_t)(chunk * numChannels + channel); };
+
+    // Deja en buffer la entrada del chunk, usando el reader del worker: del mapeo, o de la copia que guardo la pasada 1
+    auto loadChunk = [&](int worker, int chunk, juce::AudioBuffer<float>& buffer)
+        {
+            const auto numSamples = getChunkLength(chunk);
+
+            if (!mapped && chunkInputs[(size_t)chunk].getNumSamples() > 0)
+            {
+                for (int ch = 0; ch < numChannels; ++ch)
+                    buffer.copyFrom(ch, 0, chunkInputs[(size_t)chunk], ch, 0, numSamples);
+
+                return true;
+            }
+
+            if (!workerReaders[(size_t)worker]->read(&buffer, 0, numSamples, (juce::int64)chunk * chunkSize, true, true))
+                return false;
+
+            if (!mapped)
+            {
+                auto& kept = chunkInputs[(size_t)chunk];
+                kept.setSize(numChannels, numSamples);
+
+                for (int ch = 0; ch < numChannels; ++ch)
+                    kept.copyFrom(ch, 0, buffer, ch, 0, numSamples);
+            }
+
+            return true;
+        };
+
+    std::atomic<bool> readFailed{ false };
+
+    // Un solo pool para las dos pasadas; el trabajo w usa siempre el reader y el buffer del worker w
+    juce::ThreadPool pool(numWorkers);
+
+    // Pasada 1: cada chunk desde estado cero, solo nos quedamos con el estado final
+    std::vector<std::vector<double>> zeroStateEnds((size_t)numChunks * numChannels, std::vector<double>(stateSize, 0.0));
+
+    runOnPool(pool, numWorkers, [&](int worker)
+        {
+            auto& buffer = workerBuffers[(size_t)worker];
+
+            for (int chunk = worker; chunk < numChunks; chunk += numWorkers)
+            {
+                if (!loadChunk(worker, chunk, buffer))
+                    readFailed = true;
+
+                for (int ch = 0; ch < numChannels; ++ch)
+                    cascade.process(buffer.getWritePointer(ch), getChunkLength(chunk), zeroStateEnds[getStateIndex(chunk, ch)].data());
+            }
+        });
+
+    if (readFailed.load())
+        return juce::Result::fail("Error de lectura: " + input.getFullPathName());
+
+    // Propagacion exacta del estado real de chunk en chunk (todos los chunks salvo el ultimo miden chunkSize)
+    const auto transition = cascade.getTransitionMatrix(chunkSize);
+    std::vector<std::vector<double>> initialStates((size_t)numChunks * numChannels, std::vector<double>(stateSize, 0.0));
+
+    for (int chunk = 1; chunk < numChunks; ++chunk)
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            const auto& previous = initialStates[getStateIndex(chunk - 1, ch)];
+            const auto& zeroStateEnd = zeroStateEnds[getStateIndex(chunk - 1, ch)];
+            auto& current = initialStates[getStateIndex(chunk, ch)];
+
+            for (size_t r = 0; r < stateSize; ++r)
+            {
+                double sum = zeroStateEnd[r];
+                for (size_t j = 0; j < stateSize; ++j)
+                    sum += transition[r * stateSize + j] * previous[j];
+                current[r] = sum;
+            }
+        }
+
+    // Pasada 2: por tandas de numWorkers chunks, filtrados desde su estado real y escritos en orden
+    juce::AudioBuffer<float> reference(numChannels, verify ? chunkSize : 0);
+    float maxError = 0.0f;
+
+    for (int first = 0; first < numChunks; first += numWorkers)
+    {
+        const auto count = juce::jmin(numWorkers, numChunks - first);
+
+        runOnPool(pool, count, [&](int worker)
+            {
+                const auto chunk = first + worker;
+                auto& buffer = workerBuffers[(size_t)worker];
+
+                if (!loadChunk(worker, chunk, buffer))
+                    readFailed = true;
+
+                for (int ch = 0; ch < numChannels; ++ch)
+                {
+                    auto state = initialStates[getStateIndex(chunk, ch)];
+                    cascade.process(buffer.getWritePointer(ch), getChunkLength(chunk), state.data());
+                }
+            });
+
+        if (readFailed.load())
+            return juce::Result::fail("Error de lectura: " + input.getFullPathName());
+
+        for (int worker = 0; worker < count; ++worker)
+        {
+            const auto chunk = first + worker;
+            const auto numSamples = getChunkLength(chunk);
+            const auto& buffer = workerBuffers[(size_t)worker];
+
+            if (!writer->writeFromAudioSampleBuffer(buffer, 0, numSamples))
+                return juce::Result::fail("Error de escritura: " + output.getFullPathName());
+
+            if (!verify)
+                continue;
+
+            // Referencia: el plugin mismo (processBlock en modo offline), en orden, como el render por lotes.
+            // La tanda ya termino, asi que el reader del worker 0 esta libre.
+            if (!loadChunk(0, chunk, reference))
+                return juce::Result::fail("Error de lectura: " + input.getFullPathName());
+
+            BatchRenderer::processInBlocks(processor, reference, numSamples, settings.blockSize);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                const auto* expected = reference.getReadPointer(ch);
+                const auto* actual = buffer.getReadPointer(ch);
+                for (int i = 0; i < numSamples; ++i)
+                    maxError = juce::jmax(maxError, std::abs(expected[i] - actual[i]));
+            }
+        }
+    }
+
+    lastMaxError = maxError;
+    return juce::Result::ok();
+}
@@ -0,0 +1,62 @@
+/*
+  ==============================================================================
+
+    ParallelIIRRenderer.h
+    Created: 19 Oct 2026 11:05:52am
+    Author:  usuario
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "BatchRenderer.h"
+
+struct ChainSettings;
+
+// Render exacto de un solo archivo largo usando todos los nucleos.
+// La cascada de biquads de la MonoChain es lineal e invariante, con estado s (dos valores por biquad):
+//     s[n+1] = A s[n] + B x[n]
+// Por eso cada chunk de largo L se puede filtrar desde estado cero y despues corregir:
+//     s_inicio[k+1] = s_final_desde_cero[k] + A^L s_inicio[k]
+// 1. Pasada 1 (paralela): cada chunk se filtra desde cero y solo se guarda su estado final.
+// 2. Propagacion (secuencial, barata): con A^L calculada por potencias se obtiene el estado real al inicio de cada chunk.
+// 3. Pasada 2 (paralela): cada chunk se filtra desde su estado real y se escribe en orden.
+
+// Cascada de biquads en doble precision con la misma forma (TDF-II) que juce::dsp::IIR::Filter
+struct BiquadCascade
+{
+    struct Biquad { double b0, b1, b2, a1, a2; };
+
+    std::vector<Biquad> sections;
+
+    // Toma las secciones activas de la cadena de alta calidad (doble precision), en el mismo orden en que las procesa
+    static BiquadCascade fromChain(const ChainSettings& chainSettings, double sampleRate);
+
+    int getStateSize() const { return 2 * (int)sections.size(); }
+
+    // Filtra en el lugar partiendo de 'state' y deja ahi el estado final
+    void process(float* samples, int numSamples, double* state) const;
+
+    // Matriz (row-major) que avanza el estado numSamples muestras con entrada cero
+    std::vector<double> getTransitionMatrix(juce::int64 numSamples) const;
+};
+
+class ParallelIIRRenderer
+{
+public:
+    explicit ParallelIIRRenderer(RenderSettings settingsToUse);
+
+    // verify: ademas pasa el archivo por SimpleEQAudioProcessor::processBlock en modo offline (lo mismo que
+    // BatchRenderer::renderFile) y reporta la diferencia maxima
+    juce::Result renderFile(const juce::File& input, const juce::File& output, bool verify) const;
+
+    float getLastMaxError() const { return lastMaxError.load(); }
+
+    void setChunkSize(int newChunkSize) { chunkSize = juce::jmax(1024, newChunkSize); }
+
+private:
+    RenderSettings settings;
+    int chunkSize = 1 << 20;
+    mutable std::atomic<float> lastMaxError{ 0.0f };
+};
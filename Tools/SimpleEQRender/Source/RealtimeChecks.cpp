@@ -0,0 +1,198 @@
+/*
+  ==============================================================================
+
+    RealtimeChecks.cpp
+    Created: 21 Oct 2026 10:47:03am
+    Author:  usuario
+
+  ==============================================================================
+*/
+
+#include "RealtimeChecks.h"
+
+// Todo este archivo es de la configuracion RealtimeChecks (SIMPLEEQ_REALTIME_CHECKS=1). En Debug y Release queda vacio,
+// asi los comandos normales de la herramienta no pasan por los hooks de malloc y pthread_mutex_lock.
+#if SIMPLEEQ_REALTIME_CHECKS
+
+#include "AllocationCounter.h"
+#include "../../../Source/PluginProcessor.h"
+
+#include <cstring>
+
+#if JUCE_LINUX
+ #include <dlfcn.h>
+ #include <execinfo.h>
+ #include <pthread.h>
+ #include <unistd.h>
+#endif
+
+namespace
+{
+    thread_local bool reporting = false;
+
+    void writeToStderr(const char* text) noexcept
+    {
+       #if JUCE_LINUX
+        auto ignored = ::write(2, text, std::strlen(text));
+        juce::ignoreUnused(ignored);
+       #else
+        std::fputs(text, stderr);
+       #endif
+    }
+}
+
+void RealtimeCheck::check(const char* what) noexcept
+{
+    if (audioThreadDepth == 0 || reporting || !enabled.load(std::memory_order_relaxed))
+        return;
+
+    // A partir de aca cualquier allocation del reporte ya no cuenta
+    reporting = true;
+    audioThreadDepth = 0;
+
+    writeToStderr("\nViolacion de tiempo real en el hilo de audio: ");
+    writeToStderr(what);
+    writeToStderr("\n");
+
+   #if JUCE_LINUX
+    void* frames[64];
+    const auto numFrames = backtrace(frames, 64);
+    backtrace_symbols_fd(frames, numFrames, 2);
+   #endif
+
+    std::abort();
+}
+
+//==============================================================================
+// Hooks de glibc: reemplazamos malloc y compania y delegamos en las versiones internas de libc.
+// operator new/delete pasan por aca (y tambien avisan en AllocationCounter.cpp, para plataformas sin estos hooks).
+// Tambien cuentan para AllocationCounter, asi el benchmark ve las allocations de HeapBlock y no solo las de operator new.
+// Las firmas llevan noexcept porque glibc las declara con __THROW.
+#if JUCE_LINUX
+extern "C"
+{
+    void* __libc_malloc(size_t);
+    void* __libc_calloc(size_t, size_t);
+    void* __libc_realloc(void*, size_t);
+    void __libc_free(void*);
+
+    void* malloc(size_t size) noexcept
+    {
+        RealtimeCheck::check("malloc");
+        AllocationCounter::noteAllocation();
+        return __libc_malloc(size);
+    }
+
+    void* calloc(size_t numElements, size_t size) noexcept
+    {
+        RealtimeCheck::check("calloc");
+        AllocationCounter::noteAllocation();
+        return __libc_calloc(numElements, size);
+    }
+
+    void* realloc(void* p, size_t size) noexcept
+    {
+        RealtimeCheck::check("realloc");
+        AllocationCounter::noteAllocation();
+        return __libc_realloc(p, size);
+    }
+
+    void free(void* p) noexcept
+    {
+        if (p != nullptr)
+            RealtimeCheck::check("free");
+
+        __libc_free(p);
+    }
+
+    int pthread_mutex_lock(pthread_mutex_t* mutex) noexcept
+    {
+        // La version real se busca una sola vez; dlsym usa locks internos de glibc, no este simbolo
+        using MutexLockFunction = int (*)(pthread_mutex_t*);
+        static std::atomic<MutexLockFunction> realMutexLock{ nullptr };
+
+        auto function = realMutexLock.load(std::memory_order_relaxed);
+        if (function == nullptr)
+        {
+            function = reinterpret_cast<MutexLockFunction>(dlsym(RTLD_NEXT, "pthread_mutex_lock"));
+            realMutexLock.store(function, std::memory_order_relaxed);
+        }
+
+        RealtimeCheck::check("pthread_mutex_lock");
+        return function(mutex);
+    }
+}
+#endif
+
+//==============================================================================
+namespace
+{
+    void setParameter(juce::AudioProcessorValueTreeState& apvts, const juce::String& paramID, float normalisedValue)
+    {
+        auto* param = apvts.getParameter(paramID);
+        jassert(param != nullptr);
+        param->setValueNotifyingHost(normalisedValue);
+    }
+}
+
+int runRealtimeChecks(int blockSize, double sampleRate, int numBlocks, juce::int64 seed)
+{
+   #if JUCE_LINUX
+    // backtrace() carga libgcc la primera vez y eso aloca: lo hacemos antes de activar los chequeos
+    void* frames[4];
+    backtrace(frames, 4);
+
+    // Y resolvemos el pthread_mutex_lock real antes de entrar al hilo de audio
+    pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+    pthread_mutex_lock(&mutex);
+    pthread_mutex_unlock(&mutex);
+   #endif
+
+    SimpleEQAudioProcessor processor;
+    processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+    processor.prepareToPlay(sampleRate, blockSize);
+
+    juce::AudioBuffer<float> buffer(2, blockSize);
+    juce::MidiBuffer midi;
+    juce::Random random(seed);
+
+    const juce::StringArray paramIDs{ "LowCut Freq", "HighCut Freq", "Peak Freq", "Peak Gain", "Peak Q",
+                                      "LowCut Slope", "HighCut Slope", "LowCut Bypass", "Peak Bypass", "HighCut Bypass",
+                                      "Analyzer Enabled" };
+
+    // Como con un editor abierto: processBlock empuja a las FIFOs del analizador (si "Analyzer Enabled" esta prendido),
+    // que es justo lo que estos chequeos tienen que cubrir
+    processor.setAnalyzerEditorOpen(true);
+
+    RealtimeCheck::enabled = true;
+
+    for (int block = 0; block < numBlocks; ++block)
+    {
+        // Lo que hace el host entre bloques queda fuera del chequeo
+        for (int ch = 0; ch < 2; ++ch)
+            for (int i = 0; i < blockSize; ++i)
+                buffer.setSample(ch, i, random.nextFloat() * 2.0f - 1.0f);
+
+        setParameter(processor.apvts, paramIDs[random.nextInt(paramIDs.size())], random.nextFloat());
+
+        // Pasamos tambien por el render offline y los crossfades entre ambos modos
+        if (block % 97 == 0)
+            processor.setNonRealtime(!processor.isNonRealtime());
+
+        // El "editor" vacia las FIFOs de vez en cuando: asi se pasa tanto por el push normal como por el de FIFO llena
+        if (block % 50 == 0)
+        {
+            processor.leftChannelFifo.discardAll();
+            processor.rightChannelFifo.discardAll();
+        }
+
+        processor.processBlock(buffer, midi);
+    }
+
+    RealtimeCheck::enabled = false;
+    processor.setAnalyzerEditorOpen(false);
+    processor.releaseResources();
+    return numBlocks;
+}
+
+#endif
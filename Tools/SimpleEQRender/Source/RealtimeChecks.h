@@ -0,0 +1,21 @@
+/*
+  ==============================================================================
+
+    RealtimeChecks.h
+    Created: 21 Oct 2026 10:47:03am
+    Author:  usuario
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "../../../Source/ChequeoTiempoReal.h"
+
+// Solo en la configuracion RealtimeChecks, que compila con SIMPLEEQ_REALTIME_CHECKS=1.
+// Corre processBlock con los chequeos de tiempo real activos (ver ChequeoTiempoReal.h), con automatizacion
+// al azar entre bloques y pasando por el modo offline. Si hay una allocation o un lock en el hilo de audio
+// el programa aborta con el stack; si no, devuelve la cantidad de bloques procesados.
+#if SIMPLEEQ_REALTIME_CHECKS
+int runRealtimeChecks(int blockSize, double sampleRate, int numBlocks, juce::int64 seed);
+#endif
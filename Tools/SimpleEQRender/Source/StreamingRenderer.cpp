@@ -0,0 +1,206 @@
+/*
+  ==============================================================================
+
+    StreamingRenderer.cpp
+    Created: 18 Oct 2026 3:40:05pm
+    Author:  usuario
+
+  ==============================================================================
+*/
+
+#include "StreamingRenderer.h"
+#include "../../../Source/PluginProcessor.h"
+#include <thread>
+
+namespace
+{
+    // Cola SPSC de indices de slot. La capacidad alcanza para todos los slots, asi que push nunca bloquea;
+    // pop espera hasta que la etapa anterior entregue algo.
+    struct SlotQueue
+    {
+        explicit SlotQueue(int numSlots) : fifo(numSlots + 1), indices((size_t)numSlots + 1) {}
+
+        void push(int slot)
+        {
+            {
+                auto write = fifo.write(1);
+                jassert(write.blockSize1 == 1);
+                indices[(size_t)write.startIndex1] = slot;
+            }
+            dataReady.signal();
+        }
+
+        int pop()
+        {
+            for (;;)
+            {
+                {
+                    auto read = fifo.read(1);
+                    if (read.blockSize1 > 0)
+                        return indices[(size_t)read.startIndex1];
+                }
+                dataReady.wait(-1);
+            }
+        }
+
+    private:
+        juce::AbstractFifo fifo;
+        std::vector<int> indices;
+        juce::WaitableEvent dataReady;
+    };
+
+    struct Slot
+    {
+        juce::AudioBuffer<float> buffer;
+        int numSamples = 0;     // 0 marca el final del archivo
+    };
+}
+
+StreamingRenderer::StreamingRenderer(RenderSettings settingsToUse) : settings(std::move(settingsToUse))
+{
+}
+
+juce::Result StreamingRenderer::renderFile(const juce::File& input, const juce::File& output) const
+{
+    if (input == output)
+        return juce::Result::fail("La salida pisaria la entrada: " + input.getFullPathName());
+
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+
+    auto* inputFormat = formatManager.findFormatForFileExtension(input.getFileExtension());
+    auto* outputFormat = formatManager.findFormatForFileExtension(output.getFileExtension());
+    if (inputFormat == nullptr || outputFormat == nullptr)
+        return juce::Result::fail("Formato desconocido: " + input.getFullPathName());
+
+    // Solo WAV y AIFF se pueden mapear en memoria
+    std::unique_ptr<juce::MemoryMappedAudioFormatReader> reader(inputFormat->createMemoryMappedReader(input));
+    if (reader == nullptr)
+        return juce::Result::fail("El formato no admite lectura mapeada en memoria: " + input.getFullPathName());
+
+    if (reader->numChannels < 1 || reader->numChannels > 2)
+        return juce::Result::fail("Solo se admiten archivos mono o estereo: " + input.getFullPathName());
+
+    output.deleteFile();
+    std::unique_ptr<juce::FileOutputStream> stream(output.createOutputStream());
+    if (stream == nullptr || stream->failedToOpen())
+        return juce::Result::fail("No se pudo crear: " + output.getFullPathName());
+
+    std::unique_ptr<juce::AudioFormatWriter> writer(outputFormat->createWriterFor(stream.get(),
+        reader->sampleRate,
+        reader->numChannels,
+        (int)reader->bitsPerSample,
+        reader->metadataValues,
+        0));
+
+    if (writer == nullptr)
+        return juce::Result::fail("El formato no acepta esta configuracion: " + output.getFullPathName());
+
+    stream.release();
+
+    // Mismo setup que el comando render, asi los dos caminos no se separan
+    SimpleEQAudioProcessor processor;
+    BatchRenderer::prepareOfflineProcessor(processor, settings, reader->sampleRate);
+
+    // Todo lo que usa el pipeline se aloca aca, antes de arrancar los hilos
+    std::array<Slot, numSlots> slots;
+    for (auto& slot : slots)
+        slot.buffer.setSize(2, settings.blockSize);
+
+    SlotQueue freeSlots(numSlots), filledSlots(numSlots), processedSlots(numSlots);
+    for (int i = 0; i < numSlots; ++i)
+        freeSlots.push(i);
+
+    std::atomic<bool> readFailed{ false }, writeFailed{ false };
+    const auto length = reader->lengthInSamples;
+    const auto blockSize = settings.blockSize;
+
+    const auto start = juce::Time::getMillisecondCounterHiRes();
+
+    // Etapa 1: lectura desde la ventana mapeada
+    std::thread readThread([&]
+        {
+            juce::Range<juce::int64> mapped;
+
+            for (juce::int64 position = 0; position < length && !readFailed.load(); position += blockSize)
+            {
+                const auto numSamples = (int)juce::jmin<juce::int64>(blockSize, length - position);
+
+                // Si el bloque se sale de la ventana, mapeamos la siguiente. Solo hay una ventana mapeada a la vez.
+                if (!mapped.contains(juce::Range<juce::int64>(position, position + numSamples)))
+                {
+                    mapped = { position, juce::jmin(length, position + mappedWindowSamples) };
+                    if (!reader->mapSectionOfFile(mapped))
+                    {
+                        readFailed = true;
+                        break;
+                    }
+                }
+
+                auto& slot = slots[(size_t)freeSlots.pop()];
+                slot.numSamples = numSamples;
+                slot.buffer.setSize(2, numSamples, false, false, true);
+
+                if (!reader->read(&slot.buffer, 0, numSamples, position, true, true))
+                    readFailed = true;
+
+                filledSlots.push((int)(&slot - slots.data()));
+            }
+
+            // Marca de fin
+            auto endSlot = freeSlots.pop();
+            slots[(size_t)endSlot].numSamples = 0;
+            filledSlots.push(endSlot);
+        });
+
+    // Etapa 3: escritura detras del DSP
+    std::thread writeThread([&]
+        {
+            for (;;)
+            {
+                auto index = processedSlots.pop();
+                auto& slot = slots[(size_t)index];
+
+                if (slot.numSamples == 0)
+                    break;
+
+                if (!writeFailed.load() && !writer->writeFromAudioSampleBuffer(slot.buffer, 0, slot.numSamples))
+                    writeFailed = true;
+
+                freeSlots.push(index);
+            }
+        });
+
+    // Etapa 2: DSP en este hilo
+    juce::MidiBuffer midi;
+
+    for (;;)
+    {
+        auto index = filledSlots.pop();
+        auto& slot = slots[(size_t)index];
+
+        if (slot.numSamples > 0)
+            processor.processBlock(slot.buffer, midi);
+
+        processedSlots.push(index);
+
+        if (slot.numSamples == 0)
+            break;
+    }
+
+    readThread.join();
+    writeThread.join();
+    processor.releaseResources();
+
+    const auto seconds = (juce::Time::getMillisecondCounterHiRes() - start) / 1000.0;
+    const auto megabytes = (double)length * reader->numChannels * sizeof(float) / (1024.0 * 1024.0);
+    lastMegabytesPerSecond = seconds > 0.0 ? megabytes / seconds : 0.0;
+
+    if (readFailed.load())
+        return juce::Result::fail("Error de lectura: " + input.getFullPathName());
+
+    if (writeFailed.load())
+        return juce::Result::fail("Error de escritura: " + output.getFullPathName());
+
+    return juce::Result::ok();
+}
@@ -0,0 +1,37 @@
+/*
+  ==============================================================================
+
+    StreamingRenderer.h
+    Created: 18 Oct 2026 3:40:05pm
+    Author:  usuario
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "BatchRenderer.h"
+
+// Render en streaming para archivos muy largos. Tres etapas en paralelo:
+// 1. Lectura: un MemoryMappedAudioFormatReader mapea una ventana fija del archivo y llena slots libres.
+// 2. DSP: el hilo que llama a renderFile() pasa cada slot por processBlock.
+// 3. Escritura: un hilo aparte escribe los slots procesados y los devuelve como libres.
+// Los slots son fijos y la ventana mapeada tambien, asi que la memoria no depende del largo del archivo.
+
+class StreamingRenderer
+{
+public:
+    explicit StreamingRenderer(RenderSettings settingsToUse);
+
+    juce::Result renderFile(const juce::File& input, const juce::File& output) const;
+
+    // Bytes de audio (float) procesados en el ultimo render, para medir el throughput
+    double getLastMegabytesPerSecond() const { return lastMegabytesPerSecond.load(); }
+
+private:
+    RenderSettings settings;
+    mutable std::atomic<double> lastMegabytesPerSecond{ 0.0 };
+
+    static constexpr int numSlots = 8;
+    static constexpr juce::int64 mappedWindowSamples = 1 << 20;
+};